@@ -1,7 +1,16 @@
+#pragma once
+
 #include <string>
 #include <iostream>
 #include <vector>
 #include <sstream>
+#include <cstdint>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <charconv>
+#include <cstring>
+#include <string_view>
 #include "../include/FileSystemException.hpp"
 
 namespace utility {
@@ -78,15 +87,120 @@ struct PathPrefix
     return res;
 }
 
-struct KMPSolver
+/**
+ * @brief Parses a non-negative decimal count given as a command argument.
+ * @throws InvalidOptionException if the argument is not a plain number.
+ */
+[[nodiscard]] inline std::size_t parseCount(const std::string& arg)
+{
+    std::size_t value{};
+    auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    if (arg.empty() || ec != std::errc{} || end != arg.data() + arg.size()) throw InvalidOptionException(arg);
+    return value;
+}
+
+/**
+ * @brief Formats a nanosecond duration with a human friendly unit, e.g. "850ns", "12.3us", "4.56ms".
+ */
+[[nodiscard]] inline std::string formatDuration(std::uint64_t ns)
+{
+    std::ostringstream ss;
+    ss << std::setprecision(3);
+
+    if (ns < 1'000) ss << ns << "ns";
+    else if (ns < 1'000'000) ss << static_cast<double>(ns) / 1e3 << "us";
+    else if (ns < 1'000'000'000) ss << static_cast<double>(ns) / 1e6 << "ms";
+    else ss << static_cast<double>(ns) / 1e9 << "s";
+
+    return ss.str();
+}
+
+/**
+ * @brief Formats a wall clock time in local time, e.g. "2024-05-01 13:37:00".
+ */
+[[nodiscard]] inline std::string formatTime(std::chrono::system_clock::time_point tp)
+{
+    const std::time_t t{std::chrono::system_clock::to_time_t(tp)};
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+
+    std::ostringstream ss;
+    ss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
+/**
+ * @brief Collects output in a bounded buffer and writes it to a stream in large chunks.
+ *
+ * Used by commands that print listings of unbounded length, so memory stays
+ * at the buffer capacity instead of the size of the whole output.
+ */
+class BufferedWriter
+{
+public:
+    explicit BufferedWriter(std::ostream& out, std::size_t capacity = 64 * 1024) : out{out}, capacity{capacity}
+    {
+        buffer.reserve(capacity);
+    }
+
+    ~BufferedWriter() { flush(); }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    BufferedWriter& operator<<(std::string_view text)
+    {
+        buffer += text;
+        if (buffer.size() >= capacity) flush();
+        return *this;
+    }
+
+    BufferedWriter& operator<<(char c)
+    {
+        buffer += c;
+        if (buffer.size() >= capacity) flush();
+        return *this;
+    }
+
+    BufferedWriter& operator<<(std::size_t value)
+    {
+        char digits[20];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        return *this << std::string_view(digits, static_cast<std::size_t>(end - digits));
+    }
+
+    /// @brief Writes out everything buffered so far.
+    void flush()
+    {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        buffer.clear();
+    }
+
+private:
+    std::ostream& out;
+    std::size_t capacity;
+    std::string buffer;
+};
+
+/**
+ * @brief Knuth-Morris-Pratt substring search.
+ *
+ * The failure table is built once per pattern, so one solver can scan many
+ * texts or find every occurrence in one. While no partial match is pending,
+ * the scan skips ahead with memchr to the next occurrence of the first byte.
+ */
+class KMPSolver
 {
-    [[nodiscard]] inline static bool solve(const std::string& text, const std::string& pattern)
+public:
+    explicit KMPSolver(std::string_view pattern) : pattern{pattern}, lps(pattern.size())
     {
-        std::size_t patternSize = pattern.size();
-        std::vector<int> lps(patternSize);
         std::size_t i{1}, j{};
-        
-        while (i < patternSize) {
+        while (i < pattern.size()) {
             if (pattern[i] == pattern[j]) {
                 lps[i] = j + 1;
                 ++i; ++j;
@@ -98,25 +212,47 @@ struct KMPSolver
                 j = lps[j - 1];
             }
         }
+    }
 
-        i = 0;
-        j = 0;
+    /**
+     * @brief Finds the first occurrence of the pattern at or after a position.
+     * @param text Text to search.
+     * @param from Position to start at.
+     * @return Position of the occurrence, or std::string_view::npos.
+     */
+    [[nodiscard]] std::size_t find(std::string_view text, std::size_t from = 0) const noexcept
+    {
+        if (pattern.empty()) return from <= text.size() ? from : std::string_view::npos;
 
+        std::size_t i{from}, j{};
         while (i < text.size()) {
+            if (j == 0) {
+                const void* first{std::memchr(text.data() + i, pattern[0], text.size() - i)};
+                if (!first) return std::string_view::npos;
+                i = static_cast<std::size_t>(static_cast<const char*>(first) - text.data());
+            }
+
             if (text[i] == pattern[j]) {
                 ++i; ++j;
-                if (j == patternSize) return true;
-            }
-            else if (j == 0) {
-                ++i;
+                if (j == pattern.size()) return i - j;
             }
             else {
-                j = lps[j - 1];
+                j = lps[j - 1];  // j > 0: the first byte always matches after the skip
             }
         }
 
-        return false;
+        return std::string_view::npos;
     }
+
+    /// @brief Checks whether a text contains a non-empty pattern.
+    [[nodiscard]] static bool solve(std::string_view text, std::string_view pattern)
+    {
+        return !pattern.empty() && KMPSolver{pattern}.find(text) != std::string_view::npos;
+    }
+
+private:
+    std::string pattern;
+    std::vector<std::size_t> lps;  ///< Length of the longest proper prefix of pattern[0, i] that is also its suffix
 };
 
 } // namespace utility
@@ -0,0 +1,413 @@
+#include "../include/FileSystemManager.hpp"
+#include "../include/History.hpp"
+#include "../utility/Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+
+/**
+ * Performance regression gate.
+ *
+ * Runs a fixed set of FileSystemManager benchmarks in several rounds, one
+ * benchmark after the other in each, so a slow phase of the machine affects
+ * all of them rather than the rounds of one. Each benchmark is summarized by
+ * the median of its round means and by their spread, the range of the round
+ * means relative to the median.
+ *
+ * A benchmark regressed when its median exceeds the baseline median by more
+ * than the threshold plus the larger of the two spreads, so the gate widens
+ * on a noisy machine instead of failing on the same tree. Exits with a
+ * non-zero status when an operation regressed.
+ *
+ * Usage:
+ *   perf-check --baseline <file> [--threshold <fraction>] [--rounds <n>] [--runs <n>]
+ *   perf-check --write-baseline <file> [--rounds <n>] [--runs <n>]
+ */
+
+namespace {
+
+using json = nlohmann::json;
+
+struct Benchmark
+{
+    std::string name;
+    std::size_t iterations;                               ///< Operations per sample
+    std::function<void(FileSystemManager&)> setup;        ///< Untimed preparation of a fresh file system
+    std::function<void(FileSystemManager&)> operation;    ///< Timed operation, must leave the tree as it found it unless reset is set
+    std::function<void(FileSystemManager&)> reset{};      ///< Untimed, restores the tree after each operation that changes it
+};
+
+struct Result
+{
+    double median{};  ///< Median over the rounds of the mean nanoseconds per operation
+    double spread{};  ///< Range of the round means, relative to the median
+};
+
+/// Builds /tree with `dirs` directories of `files` files each.
+void buildTree(FileSystemManager& fs, int dirs, int files)
+{
+    fs.mkdir("tree");
+    fs.cd("tree");
+    for (int d{}; d < dirs; ++d) {
+        std::string dir = "d" + std::to_string(d);
+        fs.mkdir(dir);
+        fs.cd(dir);
+        for (int f{}; f < files; ++f) {
+            fs.writeToFile("f" + std::to_string(f), "line " + std::to_string(f) + " of " + dir + (f % 10 == 0 ? " needle" : ""));
+        }
+        fs.cd("..");
+    }
+    fs.cd("/");
+}
+
+/// Creates `files` empty files f0..f<files-1> in the current directory.
+void fillDirectory(FileSystemManager& fs, int files)
+{
+    for (int f{}; f < files; ++f) fs.touch("f" + std::to_string(f));
+}
+
+/// Returns a request log of 20000 lines, without the last newline that writeToFile adds.
+const std::string& requestLog()
+{
+    static const std::string log = [] {
+        std::string res;
+        for (int i{}; i < 20000; ++i) res += "2024-01-01 12:00:00 INFO request " + std::to_string(i) + " served\n";
+        res.pop_back();
+        return res;
+    }();
+    return log;
+}
+
+/// Returns a history of 100000 generated command lines, with its search index built.
+History& sampleHistory()
+{
+    static History history;
+    if (history.size() == 0) {
+        for (unsigned i{}; i < 100000; ++i) history.add("cat /data/dir" + std::to_string(i * 2654435761u % 5000) + "/file" + std::to_string(i % 300) + ".log");
+        [[maybe_unused]] auto warm = history.search("warm", std::string::npos);
+    }
+    return history;
+}
+
+std::vector<Benchmark> benchmarks()
+{
+    return {
+        {"mkdir_rmdir", 1000, [] (FileSystemManager&) { }, [] (FileSystemManager& fs) {
+            fs.mkdir("d");
+            fs.rmdir("d");
+        }},
+        {"touch_rm", 1000, [] (FileSystemManager&) { }, [] (FileSystemManager& fs) {
+            fs.touch("f");
+            fs.rm("f");
+        }},
+        {"write_append", 1000, [] (FileSystemManager& fs) { fs.touch("log"); }, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", "a log line that is appended", true);
+        }, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", "");
+        }},
+        {"read_file", 1000, [] (FileSystemManager& fs) { fs.writeToFile("f", std::string(4096, 'x')); }, [] (FileSystemManager& fs) {
+            auto content = fs.readFile("f");
+        }},
+        {"ls_1000", 50, [] (FileSystemManager& fs) {
+            for (int i{}; i < 1000; ++i) fs.touch("f" + std::to_string(i));
+        }, [] (FileSystemManager& fs) {
+            auto names = fs.ls("/");
+        }},
+        {"cd_deep", 1000, [] (FileSystemManager& fs) {
+            for (int i{}; i < 16; ++i) {
+                fs.mkdir("level");
+                fs.cd("level");
+            }
+            fs.cd("/");
+        }, [] (FileSystemManager& fs) {
+            fs.cd("/level/level/level/level/level/level/level/level/level/level/level/level/level/level/level/level");
+            fs.cd("/");
+        }},
+        {"grep_r", 20, [] (FileSystemManager& fs) { buildTree(fs, 20, 50); }, [] (FileSystemManager& fs) {
+            auto matches = fs.grep("/tree", "needle", true);
+        }},
+        {"cp_r", 20, [] (FileSystemManager& fs) { buildTree(fs, 20, 50); fs.mkdir("dst"); }, [] (FileSystemManager& fs) {
+            fs.cp("/tree", "/dst", true);
+            fs.cd("/dst");
+            fs.rmdir("tree", true);
+            fs.cd("/");
+        }},
+        {"mv_r", 1000, [] (FileSystemManager& fs) { buildTree(fs, 20, 50); fs.mkdir("dst"); }, [] (FileSystemManager& fs) {
+            fs.mv("/tree", "/dst", true);
+            fs.mv("/dst/tree", "/", true);
+        }},
+        {"to_json", 20, [] (FileSystemManager& fs) { buildTree(fs, 20, 50); }, [] (FileSystemManager& fs) {
+            auto j = fs.convertToJson("/tree");
+        }},
+        {"lookup_dir_4", 1000, [] (FileSystemManager& fs) { fillDirectory(fs, 4); }, [] (FileSystemManager& fs) {
+            auto content = fs.readFile("f3");
+        }},
+        {"lookup_dir_64", 1000, [] (FileSystemManager& fs) { fillDirectory(fs, 64); }, [] (FileSystemManager& fs) {
+            auto content = fs.readFile("f63");
+        }},
+        {"lookup_dir_4096", 1000, [] (FileSystemManager& fs) { fillDirectory(fs, 4096); }, [] (FileSystemManager& fs) {
+            auto content = fs.readFile("f4095");
+        }},
+        {"du", 200, [] (FileSystemManager& fs) { buildTree(fs, 20, 50); }, [] (FileSystemManager& fs) {
+            auto usage = fs.du("/tree");
+        }},
+        {"glob_prefix", 1000, [] (FileSystemManager& fs) { fillDirectory(fs, 20000); }, [] (FileSystemManager& fs) {
+            auto cursor = fs.glob("f1999?");
+            std::string match;
+            while (fs.nextMatch(cursor, match)) { }
+        }},
+        {"complete_prefix", 1000, [] (FileSystemManager& fs) { fillDirectory(fs, 20000); }, [] (FileSystemManager& fs) {
+            auto completion = fs.complete("f1999", 100);
+        }},
+        {"walk", 200, [] (FileSystemManager& fs) { buildTree(fs, 20, 50); }, [] (FileSystemManager& fs) {
+            std::size_t nodes{};
+            fs.walk("/tree", std::numeric_limits<std::size_t>::max(), [&] (const std::string&, const FileSystemNode&, std::size_t, bool) { ++nodes; });
+        }},
+        {"ls_page_100", 1000, [] (FileSystemManager& fs) { fillDirectory(fs, 20000); }, [] (FileSystemManager& fs) {
+            std::size_t names{};
+            auto next = fs.lsPage("/", "f5000", 100, [&] (const std::string&, const FileSystemNode&) { ++names; });
+        }},
+        {"tail_10", 1000, [] (FileSystemManager& fs) {
+            std::string log;
+            for (int i{}; i < 200000; ++i) log += "2024-01-01 12:00:00 INFO request " + std::to_string(i) + " served\n";
+            fs.writeToFile("log", log);
+        }, [] (FileSystemManager& fs) {
+            [[maybe_unused]] auto lines = fs.tail("log", 10);
+        }},
+        {"wc_append", 200, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", requestLog());
+            [[maybe_unused]] auto stats = fs.wc("log");  // the first count is a full scan
+        }, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", "2024-01-01 12:00:01 INFO request served", true);
+            [[maybe_unused]] auto stats = fs.wc("log");
+        }, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", requestLog());
+            [[maybe_unused]] auto stats = fs.wc("log");
+        }},
+        {"hash_append", 200, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", requestLog());
+            auto digest = fs.hash("log", HashAlgorithm::XXH64);  // the first hash reads the whole file
+        }, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", "2024-01-01 12:00:01 INFO request served", true);
+            auto digest = fs.hash("log", HashAlgorithm::XXH64);
+        }, [] (FileSystemManager& fs) {
+            fs.writeToFile("log", requestLog());
+            auto digest = fs.hash("log", HashAlgorithm::XXH64);
+        }},
+        {"diff_tree", 1000, [] (FileSystemManager& fs) {
+            buildTree(fs, 20, 50);
+            fs.mkdir("copy");
+            fs.cp("/tree", "/copy", true);
+            [[maybe_unused]] auto changes = fs.diffTree("/tree", "/copy/tree", [] (const FileSystemManager::TreeChange&) { });  // hashes both trees once
+        }, [] (FileSystemManager& fs) {
+            fs.cd("/copy/tree/d7");
+            fs.writeToFile("f3", "edited", true);
+            fs.cd("/");
+            [[maybe_unused]] auto changes = fs.diffTree("/tree", "/copy/tree", [] (const FileSystemManager::TreeChange&) { });
+        }, [] (FileSystemManager& fs) {
+            fs.cd("/copy/tree/d7");
+            fs.writeToFile("f3", "line 3 of d7");
+            fs.cd("/");
+        }},
+        {"diff_lines", 200, [] (FileSystemManager& fs) {
+            std::string log;
+            for (int i{}; i < 20000; ++i) log += "2024-01-01 12:00:00 INFO request " + std::to_string(i) + " served\n";
+            fs.writeToFile("old", log);
+            fs.writeToFile("new", log);
+            fs.writeAt("new", log.size() / 2, "EDIT");
+        }, [] (FileSystemManager& fs) {
+            [[maybe_unused]] auto hunks = fs.diff("old", "new", 3, [] (std::string_view) { });
+        }},
+        {"sort_lines", 50, [] (FileSystemManager& fs) {
+            std::string listing;
+            for (unsigned i{}; i < 20000; ++i) listing += "/data/file" + std::to_string(i * 2654435761u % 100000) + ".log\n";
+            fs.writeToFile("listing", listing);
+        }, [] (FileSystemManager& fs) {
+            [[maybe_unused]] auto lines = fs.sort("listing", {});
+        }},
+        {"sed_literal", 50, [] (FileSystemManager& fs) {
+            std::string log;
+            for (int i{}; i < 20000; ++i) log += (i % 3 ? "INFO request " : "WARN request ") + std::to_string(i) + " served\n";
+            fs.writeToFile("log", log);
+        }, [] (FileSystemManager& fs) {
+            fs.substitute("log", Substitution{"s/INFO/NOTICE/g"}, [] (std::string_view) { });
+        }},
+        {"history_search", 1000, [] (FileSystemManager&) { sampleHistory(); }, [] (FileSystemManager&) {
+            [[maybe_unused]] auto found = sampleHistory().search("dir4242/file17", std::string::npos);
+        }},
+        {"read_symlink_chain", 1000, [] (FileSystemManager& fs) {
+            fs.writeToFile("f", std::string(4096, 'x'));
+            fs.symlink("f", "link16");
+            for (int i{15}; i >= 0; --i) fs.symlink("link" + std::to_string(i + 1), "link" + std::to_string(i));
+        }, [] (FileSystemManager& fs) {
+            [[maybe_unused]] auto view = fs.readRange("link0", 0, 16);
+        }},
+    };
+}
+
+/// Runs a benchmark `runs` times on fresh file systems and returns the mean nanoseconds per operation.
+double measure(const Benchmark& bench, std::size_t runs)
+{
+    std::vector<double> samples;
+
+    // The first run warms up caches and the allocator and is discarded.
+    for (std::size_t run{}; run <= runs; ++run) {
+        FileSystemManager fs;
+        bench.setup(fs);
+
+        double elapsed{};
+        if (!bench.reset) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i{}; i < bench.iterations; ++i) bench.operation(fs);
+            elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+        else {
+            // Each operation is timed on its own so the reset after it is not.
+            for (std::size_t i{}; i < bench.iterations; ++i) {
+                const auto start = std::chrono::steady_clock::now();
+                bench.operation(fs);
+                elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+                bench.reset(fs);
+            }
+        }
+
+        if (run > 0) samples.push_back(elapsed / static_cast<double>(bench.iterations));
+    }
+
+    return std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+}
+
+/// Summarizes the round means of a benchmark.
+Result summarize(std::vector<double> roundMeans)
+{
+    std::sort(roundMeans.begin(), roundMeans.end());
+    const std::size_t n{roundMeans.size()};
+    const double median{n % 2 ? roundMeans[n / 2] : (roundMeans[n / 2 - 1] + roundMeans[n / 2]) / 2};
+    return {median, median > 0 ? (roundMeans.back() - roundMeans.front()) / median : 0.0};
+}
+
+std::string formatSpread(double spread)
+{
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << spread * 100 << "%";
+    return ss.str();
+}
+
+std::string formatNs(double ns)
+{
+    return utility::formatDuration(static_cast<std::uint64_t>(std::llround(ns)));
+}
+
+int usage()
+{
+    std::cerr << "Usage: perf-check --baseline <file> [--threshold <fraction>] [--rounds <n>] [--runs <n>]\n"
+              << "       perf-check --write-baseline <file> [--rounds <n>] [--runs <n>]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> args{argv + 1, argv + argc};
+
+    std::string baselineFile;
+    bool writeBaseline{false};
+    double threshold{0.10};
+    std::size_t rounds{5};
+    std::size_t runs{5};
+
+    for (std::size_t i{}; i < args.size(); ++i) {
+        if (i + 1 == args.size()) return usage();
+
+        if (args[i] == "--baseline") baselineFile = args[++i];
+        else if (args[i] == "--write-baseline") { baselineFile = args[++i]; writeBaseline = true; }
+        else if (args[i] == "--threshold") threshold = std::stod(args[++i]);
+        else if (args[i] == "--rounds") rounds = std::stoul(args[++i]);
+        else if (args[i] == "--runs") runs = std::stoul(args[++i]);
+        else return usage();
+    }
+
+    if (baselineFile.empty() || rounds < 3 || runs < 1) return usage();
+
+    json baseline;
+    if (!writeBaseline) {
+        std::ifstream in(baselineFile);
+        if (!in.is_open()) {
+            std::cerr << "Cannot open baseline file: " << baselineFile << "\n";
+            return 2;
+        }
+        in >> baseline;
+    }
+
+    const std::vector<Benchmark> all{benchmarks()};
+    std::vector<std::vector<double>> roundMeans(all.size());
+    for (std::size_t round{}; round < rounds; ++round) {
+        for (std::size_t b{}; b < all.size(); ++b) roundMeans[b].push_back(measure(all[b], runs));
+    }
+
+    json current;
+    bool regressed{false};
+
+    std::cout << std::left << std::setw(20) << "benchmark" << std::right
+              << std::setw(12) << "baseline" << std::setw(12) << "current"
+              << std::setw(10) << "spread" << std::setw(10) << "change" << "  status\n";
+
+    for (std::size_t b{}; b < all.size(); ++b) {
+        const std::string& name{all[b].name};
+        const Result result{summarize(roundMeans[b])};
+        current["benchmarks"][name] = {{"median_ns", result.median}, {"spread", result.spread}};
+
+        std::cout << std::left << std::setw(20) << name << std::right;
+
+        if (writeBaseline || !baseline["benchmarks"].contains(name)) {
+            std::cout << std::setw(12) << "-" << std::setw(12) << formatNs(result.median)
+                      << std::setw(10) << formatSpread(result.spread) << std::setw(10) << "-" << "  " << (writeBaseline ? "recorded" : "new") << "\n";
+            continue;
+        }
+
+        const double base = baseline["benchmarks"][name]["median_ns"].get<double>();
+        const double baseSpread = baseline["benchmarks"][name].value("spread", 0.0);
+        const double change = (result.median - base) / base;
+
+        // The noise seen in either measurement widens the threshold.
+        const double allowed{1.0 + threshold + std::max(baseSpread, result.spread)};
+        std::string status{"ok"};
+        if (result.median > base * allowed) {
+            status = "REGRESSED";
+            regressed = true;
+        }
+        else if (result.median * allowed < base) {
+            status = "improved";
+        }
+
+        std::ostringstream changeText;
+        changeText << std::showpos << std::fixed << std::setprecision(1) << change * 100 << "%";
+
+        std::cout << std::setw(12) << formatNs(base) << std::setw(12) << formatNs(result.median)
+                  << std::setw(10) << formatSpread(result.spread) << std::setw(10) << changeText.str() << "  " << status << "\n";
+    }
+
+    if (writeBaseline) {
+        std::ofstream out(baselineFile, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Cannot open baseline file: " << baselineFile << "\n";
+            return 2;
+        }
+        out << current.dump(4) << "\n";
+        return 0;
+    }
+
+    if (regressed) {
+        std::cout << "\nPerformance regression beyond " << threshold * 100 << "% plus the spread detected\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Process-wide heap allocation counters.
+ *
+ * The counters are fed by the replaced global operator new/delete
+ * (see AllocationTracker.cpp), including the std::align_val_t overloads
+ * used for over-aligned types, so every allocation made through
+ * new/delete, including those made by standard containers, is accounted.
+ *
+ * Usage:
+ * - Take a snapshot before and after a piece of work and subtract them.
+ * - Call resetPeak() first to measure the peak live heap reached by that work.
+ */
+class AllocationTracker
+{
+public:
+    /// @brief Point-in-time copy of the allocation counters.
+    struct Snapshot
+    {
+        std::size_t allocations{};    ///< Number of successful operator new calls
+        std::size_t deallocations{};  ///< Number of operator delete calls on non-null pointers
+        std::size_t bytesAllocated{}; ///< Total bytes requested through operator new
+        std::size_t liveBytes{};      ///< Bytes currently allocated and not yet freed
+        std::size_t peakLiveBytes{};  ///< Highest liveBytes value since the last resetPeak()
+    };
+
+    /**
+     * @brief Reads the current counter values.
+     * @return Snapshot of all counters.
+     */
+    static Snapshot snapshot() noexcept;
+
+    /**
+     * @brief Resets the peak watermark to the current live byte count.
+     */
+    static void resetPeak() noexcept;
+};
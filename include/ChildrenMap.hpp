@@ -0,0 +1,199 @@
+#pragma once
+
+#include "FileSystemNode.hpp"
+
+#include <array>
+#include <map>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Ordered name -> node container holding the children of a Directory.
+ *
+ * Iteration always visits children sorted by name, so listings are stable
+ * and prefix/range queries are a lower_bound away.
+ *
+ * Design:
+ * - Names are not copied: every key is a view of the child's own name.
+ * - Small directories (the common case) keep up to smallCapacity nodes in
+ *   an inline array sorted by name and searched linearly: no heap
+ *   allocation at all.
+ * - Past smallCapacity the entries are promoted to a heap-allocated
+ *   std::map, whose iterators stay valid across inserts. Once it grows
+ *   past indexThreshold, a hash side index makes lookups O(1) on average.
+ *   The index is a flat open-addressing table of map iterators (8 bytes
+ *   per slot, at most half full) rather than a node-based hash map.
+ * - Shrinking demotes back (map to inline at smallCapacity / 2, index
+ *   dropped at indexThreshold / 2); the gaps avoid flapping at the limits.
+ *
+ * Inserting or erasing invalidates iterators while the entries are inline
+ * and whenever the representation changes.
+ */
+class ChildrenMap
+{
+public:
+    using Node = std::shared_ptr<FileSystemNode>;
+
+    /// @brief Maximum number of entries stored inline.
+    static constexpr std::size_t smallCapacity{8};
+
+    /// @brief Size from which lookups go through the hash side index.
+    static constexpr std::size_t indexThreshold{64};
+
+private:
+    using Storage = std::map<std::string_view, Node>;
+
+    /// Representation used above smallCapacity.
+    struct Large
+    {
+        Storage entries;
+        std::vector<Storage::iterator> index;  ///< Linear-probing slots, entries.end() marks a free slot; empty while below indexThreshold
+    };
+
+public:
+    /// @brief View of one entry; binds with `const auto& [name, node] = *it`.
+    struct EntryRef
+    {
+        const std::string& first;
+        const Node& second;
+    };
+
+    /// @brief Bidirectional iterator over entries in name order, for both representations.
+    class iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = EntryRef;
+        using difference_type = std::ptrdiff_t;
+        using reference = EntryRef;
+
+        struct pointer
+        {
+            EntryRef ref;
+            const EntryRef* operator->() const noexcept { return &ref; }
+        };
+
+        iterator() = default;
+
+        reference operator*() const noexcept
+        {
+            const Node& node{small != nullptr ? *small : large->second};
+            return {node->getName(), node};
+        }
+
+        pointer operator->() const noexcept { return {**this}; }
+
+        iterator& operator++() noexcept
+        {
+            if (small != nullptr) ++small;
+            else ++large;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept { auto copy{*this}; ++*this; return copy; }
+
+        iterator& operator--() noexcept
+        {
+            if (small != nullptr) --small;
+            else --large;
+            return *this;
+        }
+
+        iterator operator--(int) noexcept { auto copy{*this}; --*this; return copy; }
+
+        bool operator==(const iterator& other) const noexcept
+        {
+            return (small != nullptr || other.small != nullptr) ? small == other.small : large == other.large;
+        }
+
+    private:
+        friend class ChildrenMap;
+
+        explicit iterator(const Node* entry) noexcept : small{entry} { }
+        explicit iterator(Storage::const_iterator it) noexcept : large{it} { }
+
+        const Node* small{nullptr};        ///< Position in the inline array, null in large mode
+        Storage::const_iterator large{};   ///< Position in the map, unused in small mode
+    };
+
+    using const_iterator = iterator;
+
+    ChildrenMap() = default;
+    ChildrenMap(const ChildrenMap&) = delete;
+    ChildrenMap& operator=(const ChildrenMap&) = delete;
+
+    iterator begin() const noexcept { return large ? iterator{large->entries.cbegin()} : iterator{inline_.data()}; }
+    iterator end() const noexcept { return large ? iterator{large->entries.cend()} : iterator{inline_.data() + smallSize}; }
+
+    std::size_t size() const noexcept { return large ? large->entries.size() : smallSize; }
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief Finds a child by name.
+     * @param name Child name.
+     * @return Iterator to the entry, or end() if absent.
+     */
+    iterator find(std::string_view name) const;
+
+    /**
+     * @brief Checks whether a child exists.
+     * @param name Child name.
+     */
+    bool contains(std::string_view name) const { return find(name) != end(); }
+
+    /**
+     * @brief Inserts a child under its own name unless the name is taken.
+     * @param node Child node.
+     * @return Iterator to the entry and whether the insertion took place.
+     */
+    std::pair<iterator, bool> emplace(Node node);
+
+    /**
+     * @brief Removes the entry at the given position.
+     * @param it Valid iterator into this container.
+     */
+    void erase(iterator it);
+
+    /**
+     * @brief Returns the first child whose name is strictly greater than the given one.
+     * @param name Name to continue after.
+     */
+    iterator upperBound(std::string_view name) const;
+
+    /**
+     * @brief Returns the children whose names start with a prefix, in order.
+     * @param prefix Name prefix, empty for all children.
+     * @return Half-open [first, last) range.
+     */
+    std::pair<iterator, iterator> prefixRange(std::string_view prefix) const;
+
+private:
+    /// @brief First entry whose name is not less than the given one.
+    iterator lowerBound(std::string_view name) const;
+
+    /// @brief Moves the inline entries into a map.
+    void promote();
+
+    /// @brief Moves the map entries back inline.
+    void demote();
+
+    /// @brief Builds or drops the hash side index after the size changed.
+    void updateIndex();
+
+    /// @brief Looks a name up in the side index, returns entries.end() if absent.
+    Storage::iterator indexFind(std::string_view name) const;
+
+    /// @brief Adds a map entry to the side index, growing it as needed.
+    void indexInsert(Storage::iterator it);
+
+    /// @brief Removes a map entry from the side index.
+    void indexErase(Storage::iterator it);
+
+    /// @brief Rebuilds the side index with the given number of slots (a power of two).
+    void indexRebuild(std::size_t slots);
+
+private:
+    std::array<Node, smallCapacity> inline_{};   ///< Nodes [0, smallSize) sorted by name while small
+    std::size_t smallSize{};
+    std::unique_ptr<Large> large;                ///< Set while promoted
+};
@@ -16,15 +16,38 @@ public:
     /// @brief Constructs a CommandParser and registers all supported commands.
     CommandParser();
 
-    /// @brief Parses the user input into a list of command and arguments.
+    // Factories such as the one for time refer back to the parser, so it stays in place.
+    CommandParser(const CommandParser&) = delete;
+    CommandParser& operator=(const CommandParser&) = delete;
+
+    /// @brief A word of the command line.
+    struct Word
+    {
+        std::string text;      ///< The word without quotes; for patterns, quoted wildcards are backslash-escaped
+        bool pattern{};        ///< True if the word has unquoted wildcards and is to be expanded (see FileSystemManager::glob)
+        std::string literal;   ///< For patterns, the word without quotes, passed on as is when nothing matches
+    };
+
+    /// @brief Splits the user input into words.
+    ///
+    /// Words are separated by whitespace. Single and double quotes group text,
+    /// including spaces, and keep wildcards literal; a backslash makes the next
+    /// character literal. A quote with no closing partner is literal.
+    ///
     /// @param input The entire input string entered by the user.
-    /// @return A vector of strings, where the first element is the command and the rest are arguments.
-    std::vector<std::string> parse(const std::string& input) const;   
+    /// @return The words, where the first one is the command and the rest are arguments.
+    /// @throws InvalidOperationException If a quote is closed only by escaped quotes.
+    std::vector<Word> parse(const std::string& input) const;
 
     /// @brief Creates a command object based on the command name.
     /// @param name The name of the command.
     /// @return A unique_ptr to the corresponding Command object, or nullptr if the command does not exist.
-    std::unique_ptr<Command> createCommand(const std::string& name) const; 
+    std::unique_ptr<Command> createCommand(const std::string& name) const;
+
+    /// @brief Lists the registered command names starting with a prefix.
+    /// @param prefix The beginning of a command name.
+    /// @return Matching names, sorted.
+    std::vector<std::string> commandNames(std::string_view prefix) const;
 
 private:
     /// @brief Stores command name to factory function mapping.
@@ -46,6 +69,10 @@ public:
     /// @param fsManager The file system manager to operate on.
     /// @param args The arguments provided to the command.
     virtual void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) = 0;
+
+    /// @brief Whether every argument is an independent operand, so a long argument
+    /// list (e.g. from a glob) may be run in several batches instead of all at once.
+    virtual bool batchesOperands() const noexcept { return false; }
 };
 
 /// @brief Prints the current working directory.
@@ -82,9 +109,14 @@ public:
 class LSCommand : public Command
 {
 public:
-    bool validate(const std::vector<std::string>& args) const noexcept override { return args.empty() || args.size() == 1; }
-
-    /// @brief Prints the contents of the specified directory (or current directory if none).
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() <= 6; }
+
+    /**
+     * @brief Prints the contents of the specified directory (or current directory if none).
+     *
+     * Supports -l for sizes and times, -R to list subdirectories recursively,
+     * and paging with --limit N and --after <name>.
+     */
     void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
 };
 
@@ -102,10 +134,12 @@ public:
 class RMDCommand : public Command
 {
 public:
-    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 1; }
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty(); }
 
-    /// @brief Deletes the specified file.
+    /// @brief Deletes the specified files.
     void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+
+    bool batchesOperands() const noexcept override { return true; }
 };
 
 /// @brief Creates files.
@@ -132,10 +166,12 @@ public:
 class CATCommand : public Command
 {
 public:
-    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 1; }
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty(); }
 
-    /// @brief Prints the content of the specified file.
+    /// @brief Prints the content of the specified files, one after another.
     void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+
+    bool batchesOperands() const noexcept override { return true; }
 };
 
 /// @brief Copies files or directories.
@@ -177,3 +213,267 @@ public:
     /// @brief Converts the specified directory to JSON and writes to the output file.
     void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
 };
+
+/// @brief Runs another command and reports its wall time, CPU time and heap usage.
+class TIMECommand : public Command
+{
+public:
+    /// @param parser Parser used to create the wrapped command.
+    explicit TIMECommand(const CommandParser& parser) : parser{parser} { }
+
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty(); }
+
+    /// @brief Executes the wrapped command and prints latency and allocation statistics.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+
+private:
+    const CommandParser& parser;
+};
+
+/// @brief Prints per-command execution metrics or exports them for Prometheus.
+class STATSCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override
+    {
+        return args.empty() || (args.size() == 2 && args[0] == "--prom");
+    }
+
+    /// @brief Prints counts, errors and latency quantiles, or writes them to a file with --prom.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Reports directory storage usage.
+class DUCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() <= 2; }
+
+    /// @brief Prints content bytes per directory. Supports optional -s to print only the total.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Reports storage used by the whole file system.
+class DFCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.empty(); }
+
+    /// @brief Prints content bytes, node counts and estimated overhead.
+    void execute(FileSystemManager& fsManager, [[maybe_unused]] const std::vector<std::string>& args) override;
+};
+
+/// @brief Turns Chrome trace-format span recording on or off.
+class TRACECommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override
+    {
+        return (args.size() == 2 && args[0] == "on") || (args.size() == 1 && args[0] == "off");
+    }
+
+    /// @brief "trace on <file>" starts recording, "trace off" writes the trace file.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Starts or stops recording executed command lines.
+class RECORDCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 1; }
+
+    /// @brief "record <file>" starts logging command lines, "record off" stops.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Prints the size and timestamps of a file or directory.
+class STATCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 1; }
+
+    /// @brief Prints type, size, creation and modification time of the given path.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Prints a directory hierarchy as a tree.
+class TREECommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() <= 3; }
+
+    /// @brief Prints the tree below a directory (current directory if none). Supports -L <depth> to limit the depth.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Prints the first lines of a file.
+class HEADCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty() && args.size() <= 3; }
+
+    /// @brief Prints the first lines of the file (10 unless -n <count> is given).
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Prints the last lines of a file.
+class TAILCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty() && args.size() <= 3; }
+
+    /// @brief Prints the last lines of the file (10 unless -n <count> is given).
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Prints a byte range of a file.
+class READCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 3; }
+
+    /// @brief Prints at most <length> bytes of the file starting at <offset>: read <file> <offset> <length>.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Writes text into a file at a byte offset.
+class WRITECommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() >= 2; }
+
+    /// @brief Overwrites the file from --at <offset> (its end if not given) with the text: write [--at offset] <file> <text...>.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Subscribes the shell to changes below a path.
+class WATCHCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() <= 2; }
+
+    /// @brief Watches a path (current directory if none), with -r for its whole subtree; lists the watches if no argument is given.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Removes a watch.
+class UNWATCHCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 1; }
+
+    /// @brief Removes the watch with the given id.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Copies a file or directory tree onto the host file system.
+class EXPORTCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 2; }
+
+    /// @brief Writes <path> to <host-path>, into it if it is an existing host directory.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Counts lines, words and bytes of files.
+class WCCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty(); }
+
+    /// @brief Prints the counts of each file and a total for several; -l, -w and -c select the columns.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Prints the XXH64 checksum of files.
+class SUMCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty(); }
+
+    /// @brief Prints "<checksum>  <file>" for each file, in the format of xxhsum.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+
+    bool batchesOperands() const noexcept override { return true; }
+};
+
+/// @brief Prints content hashes of a file or a directory tree.
+class HASHCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty() && args.size() <= 3; }
+
+    /// @brief Prints "<hash>  <path>" for a file, or with -r for every file below a directory (current directory if none); --sha256 selects SHA-256 instead of XXH64.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Lists the differences between two trees.
+class DIFFTREECommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() == 2; }
+
+    /// @brief Prints one line per difference: A (only in the second), D (only in the first), M (content or link target differs) or T (type differs).
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Compares two files line by line.
+class DIFFCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() >= 2 && args.size() <= 5; }
+
+    /// @brief Prints a unified diff of <fileA> and <fileB> with 3 lines of context, or -U <count>; nothing if they are equal.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Creates hard links and symbolic links.
+class LNCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty() && args.size() <= 3; }
+
+    /// @brief Links <link> (the current directory if omitted) to <target>: a hard link sharing the target's content, or with -s a symbolic link holding the target path.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Sorts the lines of a file.
+class SORTCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty() && args.size() <= 6; }
+
+    /// @brief Prints the lines of <file> in byte order; -r reverses, -n compares leading numbers, -u drops lines with equal keys, -o <file> writes the result to a file instead.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Collapses repeated lines of a file.
+class UNIQCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return !args.empty() && args.size() <= 2; }
+
+    /// @brief Prints each run of equal adjacent lines of <file> once, prefixed by its length with -c.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Search and replace in a file.
+class SEDCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() >= 2 && args.size() <= 4; }
+
+    /// @brief Applies 's/pattern/replacement/flags' to <file> and prints the result, or with -i stores it in the file; -E takes an extended regular expression.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
+
+/// @brief Lists the command history.
+class HISTORYCommand : public Command
+{
+public:
+    bool validate(const std::vector<std::string>& args) const noexcept override { return args.size() <= 1; }
+
+    /// @brief Prints the entries with their numbers for !n, all of them or the last <count>.
+    void execute(FileSystemManager& fsManager, const std::vector<std::string>& args) override;
+};
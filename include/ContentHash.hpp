@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Streaming XXH64, a fast non-cryptographic 64-bit hash.
+ *
+ * Produces the same values as the reference xxHash implementation (and
+ * `xxhsum -H64`), so digests can be compared with files exported to the host.
+ * Data may be fed in any number of pieces; digest() does not end the stream,
+ * so a cached state keeps absorbing appended bytes.
+ */
+class Xxh64
+{
+public:
+    explicit Xxh64(std::uint64_t seed = 0) noexcept;
+
+    /// @brief Absorbs more bytes.
+    void update(std::string_view data) noexcept;
+
+    /// @brief Hash of all bytes absorbed so far.
+    std::uint64_t digest() const noexcept;
+
+private:
+    std::array<std::uint64_t, 4> acc;      ///< Lane accumulators
+    std::array<unsigned char, 32> buffer;  ///< Bytes not yet forming a full stripe
+    std::size_t buffered{};
+    std::uint64_t totalLength{};
+    std::uint64_t seed;
+};
+
+/**
+ * @brief Streaming SHA-256 (FIPS 180-4).
+ *
+ * Like Xxh64, digest() does not end the stream.
+ */
+class Sha256
+{
+public:
+    using Digest = std::array<std::uint8_t, 32>;
+
+    Sha256() noexcept;
+
+    /// @brief Absorbs more bytes.
+    void update(std::string_view data) noexcept;
+
+    /// @brief Hash of all bytes absorbed so far.
+    Digest digest() const noexcept;
+
+private:
+    /// @brief Processes one 64 byte block.
+    void compress(const unsigned char* block) noexcept;
+
+    std::array<std::uint32_t, 8> state;
+    std::array<unsigned char, 64> buffer;  ///< Bytes not yet forming a full block
+    std::size_t buffered{};
+    std::uint64_t totalLength{};
+};
+
+/// @brief Hash algorithms offered by the sum and hash commands.
+enum class HashAlgorithm : std::uint8_t { XXH64, SHA256 };
+
+/**
+ * @brief Formats bytes as lower-case hex.
+ */
+std::string toHex(const unsigned char* data, std::size_t size);
+
+/**
+ * @brief Formats an XXH64 value the way xxhsum does (big-endian hex, 16 digits).
+ */
+std::string toHex(std::uint64_t value);
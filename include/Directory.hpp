@@ -2,7 +2,7 @@
 
 #include "FileSystemNode.hpp"
 #include "FileSystemException.hpp"
-#include <unordered_map>
+#include "ChildrenMap.hpp"
 #include <algorithm>
 
 /**
@@ -17,25 +17,29 @@
 class Directory : public FileSystemNode, public std::enable_shared_from_this<Directory>
 {
     friend class FileSystemManager;
+    friend class File;
 
 public:
+    /// @brief Kind tag of every Directory, see nodeCast.
+    static constexpr Kind staticKind{Kind::DIRECTORY};
+
     /**
      * @brief Constructs a directory with the given name.
      * @param name Name of the directory.
      */
-    explicit Directory(const std::string& name) : dirName{name} { }
+    explicit Directory(const std::string& name) : FileSystemNode{name, staticKind} { }
 
     /**
-     * @brief Gets the number of children in the directory.
-     * @return Number of files and subdirectories.
+     * @brief Gets the number of nodes below this directory.
+     * @return Number of files and subdirectories in the whole subtree, in O(1).
      */
-    virtual std::size_t getSize() const override;
+    virtual std::size_t getSize() const noexcept override { return subtreeUsage.files + subtreeUsage.directories; }
 
     /**
-     * @brief Returns the name of the directory.
-     * @return Directory name as string.
+     * @brief Gets the storage used by this directory and its subtree, in O(1).
+     * @return Subtree usage plus this directory itself.
      */
-    virtual std::string getName() const override { return dirName; }
+    virtual Usage getUsage() const noexcept override;
 
     /**
      * @brief Creates a new subdirectory.
@@ -70,10 +74,34 @@ public:
     void createOrUpdateFile(const std::string& name);
 
     /**
-     * @brief Lists the names of all children (files and directories).
+     * @brief Lists the names of the children (files and directories), sorted by name.
+     * @param prefix Only lists children whose names start with this prefix (all if empty).
      * @return Vector of child names.
      */
-    std::vector<std::string> ls() const;
+    std::vector<std::string> ls(std::string_view prefix = {}) const;
+
+    /**
+     * @brief Visits children in name order, starting after a cursor, without copying names.
+     *
+     * The cursor is a name rather than a position, so resuming from the last
+     * visited name neither repeats nor skips entries when children are added
+     * or removed in between; new names are seen if they sort after the cursor.
+     *
+     * @param after Only visits names greater than this one (all if empty).
+     * @param limit Maximum number of children to visit.
+     * @param visit Called with the name and node of each child.
+     * @return True if more children follow the last one visited.
+     */
+    template <typename Visitor>
+    bool forEachChild(std::string_view after, std::size_t limit, Visitor&& visit) const
+    {
+        auto it = after.empty() ? children.begin() : children.upperBound(after);
+        for (; it != children.end() && limit; ++it, --limit) {
+            visit(it->first, *it->second);
+        }
+
+        return it != children.end();
+    }
 
     /**
      * @brief Computes the full path from the root to this directory.
@@ -82,10 +110,28 @@ public:
     std::string getFullPath() const override;
 
     /**
-     * @brief Checks if this node is a directory.
-     * @return Always true for Directory.
+     * @brief Gets the Merkle hash of the subtree.
+     *
+     * XXH64 over the children in name order, each contributing its kind, name
+     * and hash (content hash for files, Merkle hash for directories). The
+     * directory's own name is not included, so equal trees hash equally
+     * wherever they are. The hash is cached: a change marks only the
+     * directories on the path to the root dirty, and the next call recomputes
+     * only those.
+     *
+     * @return Hash of the subtree.
+     */
+    std::uint64_t treeHash() const;
+
+    /**
+     * @brief Gets the structure generation of the file system.
+     *
+     * Incremented whenever any directory gains or loses a child, so a value
+     * that has not changed means every path still names the same node.
+     *
+     * @return Current generation, never 0.
      */
-    virtual bool isDirectory() const noexcept override { return true; }
+    static std::uint64_t generation() noexcept { return structureGeneration; }
 
 private:
     /**
@@ -96,14 +142,38 @@ private:
 
     /**
      * @brief Removes a child node from this directory.
+     *
+     * The removed node is detached (it has no parent afterwards), so a hard
+     * link that outlives its entry no longer reports changes here.
+     *
      * @param name Name of the child to remove.
      */
     void removeChild(const std::string& name) noexcept;
 
+    /**
+     * @brief Applies a usage change to this directory and all its ancestors.
+     * @param added Usage that appeared below this directory.
+     * @param removed Usage that disappeared below this directory.
+     */
+    void propagateUsage(const Usage& added, const Usage& removed) noexcept;
+
+    /**
+     * @brief Marks the cached Merkle hash of this directory and its ancestors dirty.
+     *
+     * Stops at the first directory that is already dirty: a clean directory
+     * only has clean descendants, so every ancestor of a dirty one is dirty too.
+     */
+    void invalidateTreeHash() noexcept;
+
 private:
-    /// Map of child names to their corresponding nodes (files or directories).
-    std::unordered_map<std::string, std::shared_ptr<FileSystemNode>> children;
+    /// Child names mapped to their nodes (files or directories), ordered by name.
+    ChildrenMap children;
+
+    /// Usage of everything below this directory, maintained incrementally.
+    Usage subtreeUsage{};
+
+    mutable std::uint64_t cachedTreeHash{};  ///< Merkle hash, valid if treeHashValid
+    mutable bool treeHashValid{false};
 
-    /// Name of this directory.
-    std::string dirName;
+    static inline std::uint64_t structureGeneration{1};  ///< See generation()
 };
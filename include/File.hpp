@@ -1,44 +1,74 @@
 #pragma once
 
 #include "FileSystemNode.hpp"
+#include "TextStats.hpp"
+#include "ContentHash.hpp"
+
+#include <memory>
+#include <optional>
+#include <string_view>
 
 /**
  * @brief Represents a file in the file system.
  *
  * Stores the file name and its content. Provides operations to read, write, 
  * and get the size of the file. Inherits from FileSystemNode.
+ *
+ * Hard links are Files sharing one body (content and cached counts and
+ * hashes), so a link costs a node, not a copy of the bytes. The links of a
+ * body form a ring; a write through any of them updates the usage, Merkle
+ * hashes and watches of every directory holding one.
  */
 class File : public FileSystemNode
 {
 public:
+    /// @brief Kind tag of every File, see nodeCast.
+    static constexpr Kind staticKind{Kind::FILE};
+
     /**
      * @brief Constructs a File with a given name and optional content.
      * @param name Name of the file.
      * @param content Initial content of the file (default empty).
      */
     File(const std::string& name, const std::string& content = "")
-        : fileName{name}, fileContent{content} { }
+        : FileSystemNode{name, staticKind}, body{std::make_shared<Body>(content)} { }
+
+    /**
+     * @brief Constructs a hard link to an existing file.
+     * @param name Name of the new link.
+     * @param target File whose content the link shares.
+     */
+    File(const std::string& name, File& target);
+
+    /// @brief Leaves the ring of links; the content lives on while another link exists.
+    ~File() override;
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
 
     /**
      * @brief Gets the size of the file in bytes.
      * @return Size of the file content.
      */
-    virtual std::size_t getSize() const noexcept override { return fileContent.size(); }
+    virtual std::size_t getSize() const noexcept override { return body->content.size(); }
 
     /**
-     * @brief Gets the file name.
-     * @return Name of the file.
+     * @brief Gets the storage used by this file.
+     * @return Content size, one file and the name length; content shared by hard links counts once per link.
      */
-    virtual std::string getName() const override { return fileName; }
+    virtual Usage getUsage() const noexcept override { return {body->content.size(), 1, 0, nodeName.size()}; }
 
     /**
-     * @brief Gets the content of the file.
-     * @return File content as a string.
+     * @brief Gets the content of the file without copying it.
+     * @return File content, valid until the file is written or destroyed.
      */
-    std::string getContent() const { return fileContent; }
+    const std::string& getContent() const noexcept { return body->content; }
 
     /**
      * @brief Writes a message to the file.
+     *
+     * The size change is propagated to the usage totals of all ancestors.
+     *
      * @param message Message to write.
      * @param append If true, append to existing content; otherwise, overwrite.
      */
@@ -48,7 +78,89 @@ public:
      * @brief Reads the file content.
      * @return File content as a string.
      */
-    std::string read() const { return fileContent; }
+    std::string read() const { return body->content; }
+
+    /**
+     * @brief Gets the first lines of the file without copying them.
+     * @param lines Number of lines to keep.
+     * @return Prefix ending after the lines-th newline, or the whole content if it has fewer lines.
+     */
+    std::string_view head(std::size_t lines) const noexcept;
+
+    /**
+     * @brief Gets the last lines of the file without copying them.
+     *
+     * Scans backwards from the end, so the cost depends on the length of the
+     * returned lines rather than on the size of the file. A trailing newline
+     * terminates the last line and does not start a new one.
+     *
+     * @param lines Number of lines to keep.
+     * @return Suffix holding the last lines, or the whole content if it has fewer lines.
+     */
+    std::string_view tail(std::size_t lines) const noexcept;
+
+    /**
+     * @brief Overwrites bytes in place, extending the file if the data runs past its end.
+     *
+     * Unlike write, no newline is added.
+     *
+     * @param offset Position of the first byte to overwrite; must not exceed getSize().
+     * @param data Bytes to write.
+     */
+    void writeAt(std::size_t offset, std::string_view data);
+
+    /**
+     * @brief Replaces the whole content, taking over the given buffer.
+     *
+     * Unlike write, no newline is added.
+     *
+     * @param content New content.
+     */
+    void assign(std::string content);
+
+    /**
+     * @brief Gets the line, word and byte counts of the content.
+     *
+     * Counted on first use and cached; appends extend the cached counts by
+     * counting only the new bytes, other writes drop them.
+     *
+     * @return Counts of the current content.
+     */
+    const TextStats& stats() const;
+
+    /**
+     * @brief Gets the XXH64 hash of the content.
+     *
+     * The hash state is kept after the first call; appends feed it only the
+     * new bytes, other writes drop it.
+     *
+     * @return Hash of the current content.
+     */
+    std::uint64_t xxh64() const;
+
+    /**
+     * @brief Gets the SHA-256 digest of the content, cached like xxh64().
+     * @return Digest of the current content.
+     */
+    Sha256::Digest sha256() const;
+
+    /**
+     * @brief Gets the number of hard links sharing this file's content.
+     * @return 1 for a file that was never linked.
+     */
+    std::size_t linkCount() const noexcept;
+
+    /**
+     * @brief Checks whether two files are hard links of the same content.
+     * @param other File to compare with.
+     */
+    bool sharesContent(const File& other) const noexcept { return body == other.body; }
+
+    /**
+     * @brief Estimates the bytes of the content body behind a file, besides the content itself.
+     * @return Size of the body and of its make_shared control block.
+     */
+    static constexpr std::size_t bodyOverhead() noexcept;
 
     /**
      * @brief Returns the full path of the file.
@@ -56,13 +168,44 @@ public:
      */
     virtual std::string getFullPath() const override { return ""; }
 
+private:
     /**
-     * @brief Checks if this node is a directory.
-     * @return Always false for files.
+     * @brief Records a modification and propagates the size change to the ancestors of every link.
+     * @param oldSize Size of the content before the modification.
      */
-    virtual bool isDirectory() const noexcept override { return false; }
+    void contentChanged(std::size_t oldSize);
 
-private:
-    std::string fileName;     ///< Name of the file
-    std::string fileContent;  ///< Content of the file
+    /**
+     * @brief Extends the cached counts and hash states, if any, by the content appended after from.
+     * @param from Size of the content before the append.
+     */
+    void cachesAppended(std::size_t from) noexcept;
+
+    /// @brief Drops the cached counts and hash states after a write that was not an append.
+    void dropCaches() noexcept;
+
+    /// @brief Hash states, allocated on first use so files never hashed pay one pointer.
+    struct HashStates
+    {
+        std::optional<Xxh64> xxh64;
+        std::optional<Sha256> sha256;
+    };
+
+    /// @brief Content and caches, shared by all hard links of the file.
+    struct Body
+    {
+        explicit Body(const std::string& content) : content{content} { }
+
+        std::string content;                    ///< Content of the file
+        std::optional<TextStats> cachedStats;   ///< Counts of content, computed by stats()
+        std::unique_ptr<HashStates> hashes;     ///< Hash states of content, computed by xxh64() and sha256()
+    };
+
+    std::shared_ptr<Body> body;
+    File* nextLink{this};  ///< Next link in the ring of Files sharing body, this one if unlinked
 };
+
+constexpr std::size_t File::bodyOverhead() noexcept
+{
+    return sizeof(Body) + 2 * sizeof(long);
+}
@@ -14,6 +14,9 @@ public:
     {
         return message.c_str();
     }
+
+    /// @brief Name of the concrete exception type, used as a metrics label.
+    virtual const char* kind() const noexcept { return "FileSystemException"; }
 };
 
 class InvalidPathException : public FileSystemException
@@ -21,6 +24,8 @@ class InvalidPathException : public FileSystemException
 public:
     explicit InvalidPathException(const std::string& path)
         : FileSystemException("Invalid path: " + path) { }
+
+    const char* kind() const noexcept override { return "InvalidPathException"; }
 };
 
 class InvalidNameException : public FileSystemException
@@ -28,6 +33,8 @@ class InvalidNameException : public FileSystemException
 public:
     explicit InvalidNameException(const std::string& name)
         : FileSystemException("Invalid name: " + name) { }
+
+    const char* kind() const noexcept override { return "InvalidNameException"; }
 };
 
 class InvalidOptionException : public FileSystemException
@@ -35,6 +42,8 @@ class InvalidOptionException : public FileSystemException
 public:
     explicit InvalidOptionException(const std::string& option)
         : FileSystemException("Invalid option: " + option) { }
+
+    const char* kind() const noexcept override { return "InvalidOptionException"; }
 };
 
 class InvalidOperationException : public FileSystemException
@@ -42,6 +51,8 @@ class InvalidOperationException : public FileSystemException
 public:
     explicit InvalidOperationException(const std::string& message)
         : FileSystemException("Invalid operation: " + message) { }
+
+    const char* kind() const noexcept override { return "InvalidOperationException"; }
 };
 
 class DirectoryAlreadyExists : public FileSystemException
@@ -49,6 +60,8 @@ class DirectoryAlreadyExists : public FileSystemException
 public:
     explicit DirectoryAlreadyExists(const std::string& dirName)
         : FileSystemException("Directory \'" + dirName + "\' already exists") { }
+
+    const char* kind() const noexcept override { return "DirectoryAlreadyExists"; }
 };
 
 class DirectoryDoesNotExist : public FileSystemException
@@ -56,6 +69,8 @@ class DirectoryDoesNotExist : public FileSystemException
 public:
     explicit DirectoryDoesNotExist(const std::string& dirName)
         : FileSystemException("Directory \'" + dirName + "\' does not exist") { }
+
+    const char* kind() const noexcept override { return "DirectoryDoesNotExist"; }
 };
 
 class FileDoesNotExist : public FileSystemException
@@ -63,6 +78,8 @@ class FileDoesNotExist : public FileSystemException
 public:
     explicit FileDoesNotExist(const std::string& fileName)
         : FileSystemException("File \'" + fileName + "\' does not exist") { }
+
+    const char* kind() const noexcept override { return "FileDoesNotExist"; }
 };
 
 class FileAlreadyExists : public FileSystemException
@@ -70,6 +87,8 @@ class FileAlreadyExists : public FileSystemException
 public:
     explicit FileAlreadyExists(const std::string& fileName)
         : FileSystemException("File \'" + fileName + "\' already exists") { }
+
+    const char* kind() const noexcept override { return "FileAlreadyExists"; }
 };
 
 class DirectoryNotEmptyException : public FileSystemException
@@ -77,4 +96,15 @@ class DirectoryNotEmptyException : public FileSystemException
 public:
     explicit DirectoryNotEmptyException(const std::string& dirName)
         : FileSystemException("Directory \'" + dirName + "\' is not empty") { }
-};
\ No newline at end of file
+
+    const char* kind() const noexcept override { return "DirectoryNotEmptyException"; }
+};
+
+class SymlinkLoopException : public FileSystemException
+{
+public:
+    explicit SymlinkLoopException(const std::string& path)
+        : FileSystemException("Too many levels of symbolic links: " + path) { }
+
+    const char* kind() const noexcept override { return "SymlinkLoopException"; }
+};
@@ -3,8 +3,13 @@
 #include "FileSystemNode.hpp"
 #include "Directory.hpp"
 #include "File.hpp"
+#include "Symlink.hpp"
+#include "GlobPattern.hpp"
+#include "LineSort.hpp"
+#include "Substitution.hpp"
 #include "json.hpp"
 
+#include <functional>
 #include <optional>
 
 /**
@@ -14,17 +19,130 @@ class FileSystemManager {
 public:
     using json = nlohmann::json;
 
+    /// @brief Whole file system storage report produced by df().
+    struct SpaceReport
+    {
+        Usage usage;                       ///< Content bytes and node counts of the whole tree
+        std::size_t nodeOverhead{};        ///< Estimated bytes of node objects and their control blocks
+        std::size_t metadataOverhead{};    ///< Estimated bytes of names, directory index entries and timestamps
+
+        std::size_t total() const noexcept { return usage.bytes + nodeOverhead + metadataOverhead; }
+    };
+
+    /// @brief Description of a single node produced by stat().
+    struct NodeInfo
+    {
+        std::string name;          ///< Node name (the path as given for stat())
+        FileSystemNode::Kind kind{};  ///< Type of the node; stat() does not follow a final symbolic link
+        std::size_t size{};        ///< Content bytes (whole subtree for directories, target length for links)
+        std::size_t links{1};      ///< Number of hard links of a file's content
+        std::string target;        ///< Target path of a symbolic link, empty otherwise
+        NodeMetadata metadata;     ///< Creation and modification times
+    };
+
+    /// @brief What exportTree() wrote to the host.
+    struct ExportReport
+    {
+        std::size_t files{};        ///< Files written
+        std::size_t directories{};  ///< Directories created (or reused if they existed)
+        std::size_t symlinks{};     ///< Symbolic links created; absolute targets are made relative
+        std::size_t skippedSymlinks{};  ///< Symbolic links not created because they point outside the export
+        std::size_t bytes{};        ///< Content bytes written
+    };
+
+    /// @brief One difference between two trees, reported by diffTree().
+    struct TreeChange
+    {
+        enum class Type : std::uint8_t { ADDED, DELETED, MODIFIED, TYPE_CHANGED };
+
+        Type type{};
+        std::string path;   ///< Path relative to both roots; empty if the roots themselves differ
+        bool directory{};   ///< Whether the node is a directory (in the second tree, if present there)
+    };
+
+    /// @brief Children completing a partial path, produced by complete().
+    struct Completion
+    {
+        std::string common;                   ///< Longest common prefix of the matching names, '/' appended to a unique directory
+        std::vector<std::string> candidates;  ///< First matching names in order, directories with a trailing '/'
+        bool unique{};                        ///< Exactly one name matches
+        bool truncated{};                     ///< More names match than are listed in candidates
+    };
+
+    /**
+     * @brief Resumable position of a glob expansion, created by glob() and advanced by nextMatch().
+     *
+     * Each open directory keeps the name of the last child it produced rather
+     * than an iterator, so the tree may be modified between matches, e.g. by
+     * removing the files matched so far.
+     */
+    class GlobCursor
+    {
+        friend class FileSystemManager;
+
+        /// @brief One directory being searched for the component at index part.
+        struct Frame
+        {
+            std::shared_ptr<Directory> dir;  ///< Directory searched (kept alive even if removed meanwhile)
+            std::string path;                ///< Its path, spelled as in the pattern
+            std::size_t part;                ///< Index of the pattern component to match in dir
+            std::string after;               ///< Last child name taken, empty before the first
+            bool started{false};             ///< For "**": whether the zero-directory case was tried
+        };
+
+        std::vector<GlobPattern> parts;  ///< Pattern components after the literal directory prefix
+        std::vector<Frame> frames;       ///< Stack of open directories, deepest last
+    };
+
 private:
     std::shared_ptr<Directory> root;  /**< Root directory of the file system */
     std::shared_ptr<Directory> cwd;   /**< Current working directory */
 
+    /// @brief Most symbolic links followed while resolving one path, as Linux's MAXSYMLINKS.
+    static constexpr std::size_t maxSymlinkHops{40};
+
 private:
+    /**
+     * @brief Resolves a symbolic link to the node it finally points to.
+     *
+     * Reuses the target cached on the link while the tree structure is
+     * unchanged; otherwise resolves the target path relative to the directory
+     * holding the link and caches the result.
+     *
+     * @param link Link to follow.
+     * @param hops Links followed so far for the path being resolved; incremented per link.
+     * @return The final target, never a link.
+     *
+     * @throws SymlinkLoopException If more than maxSymlinkHops links are followed.
+     * @throws InvalidPathException If the link dangles.
+     */
+    std::shared_ptr<FileSystemNode> followSymlink(const Symlink& link, std::size_t& hops) const;
+
+    /**
+     * @brief Resolves a path to a node, following every symbolic link on the way, including the last.
+     * @param path Path to resolve.
+     * @param start Directory a relative path starts from.
+     * @param hops Links followed so far, see followSymlink.
+     * @return The node named by the path, never a link.
+     */
+    std::shared_ptr<FileSystemNode> lookup(const std::string& path, std::shared_ptr<Directory> start, std::size_t& hops) const;
+
+    /**
+     * @brief Resolves where a new link goes, as ln does.
+     * @param target Path the link is made for; its last component names a link placed inside a directory.
+     * @param linkPath Path of the link, or of an existing directory to create it in.
+     * @return Directory and name of the new link.
+     *
+     * @throws FileAlreadyExists If the name is already taken.
+     */
+    std::pair<std::shared_ptr<Directory>, std::string> linkDestination(const std::string& target, const std::string& linkPath) const;
+
     /**
      * @brief Copies the contents of one directory into another.
      * @param src Source directory to copy from.
      * @param dst Destination directory to copy into.
      */
-    void copyDirectory(const std::shared_ptr<Directory>& src, const std::shared_ptr<Directory> &dst);
+    void copyDirectory(const Directory& src, Directory& dst);
 
     /**
      * @brief Resolves the source path for copy or move operations.
@@ -57,6 +175,40 @@ private:
      */
     std::shared_ptr<Directory> navigateToDirectory(const std::string& path, std::shared_ptr<Directory> startNode) const;
 
+    /**
+     * @brief Splits a path into its parent directory and last component, relative to cwd.
+     * @param path Path to split.
+     * @return Resolved parent directory and the last component; the component is
+     *         empty, "." or ".." when the path can only name a directory.
+     */
+    std::pair<std::shared_ptr<Directory>, std::string> resolveParent(const std::string& path) const;
+
+    /**
+     * @brief Resolves a path to a file or directory, relative to cwd.
+     * @param path Path to resolve.
+     * @param follow Whether a symbolic link as the last component is followed or returned itself.
+     * @return Pointer to the node.
+     */
+    std::shared_ptr<FileSystemNode> findNode(const std::string& path, bool follow = true) const;
+
+    /**
+     * @brief Resolves a path to a file, relative to cwd.
+     * @param fileName Name or path of the file.
+     * @return The file, owned by its parent directory.
+     *
+     * @throws FileDoesNotExist If nothing has that name.
+     * @throws InvalidPathException If the path names a directory.
+     */
+    File& findFile(const std::string& fileName) const;
+
+    /**
+     * @brief Describes a node.
+     * @param node Node to describe.
+     * @param name Name to report.
+     * @return Size and timestamps of the node.
+     */
+    NodeInfo describe(const FileSystemNode& node, const std::string& name) const;
+
     /**
      * @brief Recursively searches for a pattern in files/directories.
      * @param node Current directory node.
@@ -64,29 +216,45 @@ private:
      * @param path Current path vector.
      * @param res Vector to store matching paths.
      */
-    void dfsAndGrep(const std::shared_ptr<Directory>& node, const std::string& pattern, std::vector<std::string>& path, std::vector<std::string>& res) const;
+    void dfsAndGrep(const Directory& node, const std::string& pattern, std::vector<std::string>& path, std::vector<std::string>& res) const;
+
+    /**
+     * @brief Collects the usage of a directory and all its subdirectories, children first.
+     * @param node Current directory node.
+     * @param path Full path of the current directory.
+     * @param res Vector to store (path, usage) pairs.
+     */
+    void dfsAndDu(const Directory& node, const std::string& path, std::vector<std::pair<std::string, Usage>>& res) const;
+
+    /**
+     * @brief Reports the differences between two directories whose hashes differ.
+     * @param first Directory of the first tree.
+     * @param second Directory of the second tree.
+     * @param prefix Relative path of both directories, ending with '/' unless empty.
+     * @param visit Called for each difference.
+     * @return Number of differences.
+     */
+    std::size_t diffDirectories(const Directory& first, const Directory& second, const std::string& prefix,
+                                const std::function<void(const TreeChange&)>& visit) const;
 
     /**
-     * @brief Safely casts a FileSystemNode to the specified derived type.
+     * @brief Safely casts a FileSystemNode to the specified derived type, sharing ownership.
      *
-     * This function wraps std::dynamic_pointer_cast with an additional runtime check.
-     * If the cast fails, it throws a std::runtime_error with a descriptive message,
-     * ensuring that invalid type assumptions are caught early.
+     * Checks the kind tag like nodeCast and then static-casts, so no RTTI is
+     * involved. Copying the shared_ptr still costs an atomic increment:
+     * traversals that do not keep the node should use nodeCast instead.
      *
      * @tparam T The target type to cast to (e.g., File, Directory).
      * @param node The FileSystemNode pointer to cast.
      * @return std::shared_ptr<T> A shared pointer to the node cast to type T.
      *
-     * @throws std::runtime_error If the node cannot be cast to the requested type T.
-     *
-     * @note Use this helper to reduce repetitive dynamic_pointer_cast + null-check code.
+     * @throws std::runtime_error If the node is not of type T.
      */
     template <typename T>
     std::shared_ptr<T> asNode(const std::shared_ptr<FileSystemNode>& node) const
     {
-        auto ptr = std::dynamic_pointer_cast<T>(node);
-        if (!ptr) throw std::runtime_error("Expected node of type: " + std::string(typeid(T).name()));
-        return ptr;
+        nodeCast<T>(*node);
+        return std::static_pointer_cast<T>(node);
     }
 public:
     /**
@@ -115,6 +283,87 @@ public:
      */
     std::vector<std::string> ls(const std::string& path) const;
 
+    /**
+     * @brief Streams one page of the contents of a directory, in name order.
+     *
+     * Nothing is materialized: names and nodes are handed to the visitor in
+     * place. Pass the returned cursor as @p after to get the next page.
+     *
+     * @param path Path of the directory to list (current directory if empty).
+     * @param after Only lists names greater than this one (from the start if empty).
+     * @param limit Maximum number of entries in the page.
+     * @param visit Called with the name and node of each entry.
+     * @return Cursor of the next page (the last listed name), or nullopt if the listing is complete.
+     */
+    std::optional<std::string> lsPage(const std::string& path, std::string_view after, std::size_t limit,
+                                      const std::function<void(const std::string&, const FileSystemNode&)>& visit) const;
+
+    /**
+     * @brief Visits every node below a directory in preorder, children in name order.
+     *
+     * Uses an explicit stack of child cursors, so memory grows with the depth
+     * of the tree, not its size. The visitor must not modify the tree.
+     *
+     * @param path Path of the directory to walk (current directory if empty).
+     * @param maxDepth Deepest level to visit; direct children are at depth 1.
+     * @param visit Called with the name, node and depth of each node, and whether it is the last of its siblings.
+     */
+    void walk(const std::string& path, std::size_t maxDepth,
+              const std::function<void(const std::string&, const FileSystemNode&, std::size_t, bool)>& visit) const;
+
+    /**
+     * @brief Visits a directory and all directories below it in preorder, subdirectories in name order.
+     *
+     * Uses an explicit stack like walk(). The visitor must not modify the tree.
+     *
+     * @param path Path of the directory to walk (current directory if empty).
+     * @param visit Called with the path of each directory, spelled from @p path, and the directory itself.
+     */
+    void walkDirectories(const std::string& path, const std::function<void(const std::string&, const Directory&)>& visit) const;
+
+    /**
+     * @brief Completes the last component of a partial path against its directory.
+     *
+     * Matching names are a contiguous range of the ordered children, and the
+     * common prefix of a sorted range is that of its first and last names, so
+     * the cost is two searches plus the listed candidates, whatever the
+     * directory size.
+     *
+     * @param partial Path typed so far, relative to cwd or absolute.
+     * @param maxCandidates Maximum number of names to list.
+     * @return Matching names; empty if the directory part does not resolve or nothing matches.
+     */
+    Completion complete(const std::string& partial, std::size_t maxCandidates) const;
+
+    /**
+     * @brief Starts expanding a shell-style pattern against the tree.
+     *
+     * Components may use the wildcards of GlobPattern, and `**` matches any
+     * number of directories (a trailing `**` matches everything below).
+     * Leading components without wildcards are resolved once, and each
+     * wildcard component only scans the children sharing its literal prefix.
+     * If they do not name a directory, the pattern has no matches.
+     *
+     * @param pattern Pattern, relative to cwd or absolute.
+     * @return Cursor to pass to nextMatch().
+     */
+    GlobCursor glob(const std::string& pattern) const;
+
+    /**
+     * @brief Produces the next path matching a glob, in name order per directory.
+     * @param cursor Cursor from glob().
+     * @param path Receives the match, spelled with the pattern's directory prefix.
+     * @return False when the expansion is complete.
+     */
+    bool nextMatch(GlobCursor& cursor, std::string& path) const;
+
+    /**
+     * @brief Describes a file or directory.
+     * @param path Path of the node.
+     * @return Size and timestamps of the node.
+     */
+    NodeInfo stat(const std::string& path) const;
+
     // File/Directory operations
 
     /**
@@ -132,7 +381,7 @@ public:
 
     /**
      * @brief Removes a file.
-     * @param name Name of the file.
+     * @param name Name or path of the file.
      */
     void rm(const std::string& name);
 
@@ -152,11 +401,156 @@ public:
 
     /**
      * @brief Reads the content of a file.
-     * @param fileName File to read.
+     * @param fileName Name or path of the file to read.
      * @return File contents as a string.
      */
     std::string readFile(const std::string& fileName) const;
 
+    /**
+     * @brief Resolves a path to the absolute path of an existing file or directory.
+     * @param path Path relative to cwd, or absolute.
+     * @return Normalized absolute path, e.g. "/a/b".
+     */
+    std::string realPath(const std::string& path) const;
+
+    /**
+     * @brief Reads a byte range of a file without copying it.
+     * @param fileName Name or path of the file.
+     * @param offset Position of the first byte; must not exceed the file size.
+     * @param length Maximum number of bytes, clamped to the end of the file.
+     * @return View into the file, valid until the file is modified or removed.
+     */
+    std::string_view readRange(const std::string& fileName, std::size_t offset, std::size_t length) const;
+
+    /**
+     * @brief Reads the first lines of a file without copying them.
+     * @param fileName Name or path of the file.
+     * @param lines Number of lines.
+     * @return View into the file, valid until the file is modified or removed.
+     */
+    std::string_view head(const std::string& fileName, std::size_t lines) const;
+
+    /**
+     * @brief Reads the last lines of a file by scanning backwards from its end.
+     * @param fileName Name or path of the file.
+     * @param lines Number of lines.
+     * @return View into the file, valid until the file is modified or removed.
+     */
+    std::string_view tail(const std::string& fileName, std::size_t lines) const;
+
+    /**
+     * @brief Overwrites part of a file in place, extending it if the data runs past its end.
+     * @param fileName Name or path of the file.
+     * @param offset Position of the first byte to overwrite; must not exceed the file size.
+     * @param data Bytes to write.
+     */
+    void writeAt(const std::string& fileName, std::size_t offset, std::string_view data);
+
+    /**
+     * @brief Appends to an existing file, following symbolic links to it.
+     * @param fileName Name or path of the file.
+     * @param data Bytes to append.
+     */
+    void appendTo(const std::string& fileName, std::string_view data);
+
+    /**
+     * @brief Counts the lines, words and bytes of a file.
+     * @param fileName Name or path of the file.
+     * @return Counts cached on the file; after an append only the new bytes are counted.
+     */
+    TextStats wc(const std::string& fileName) const;
+
+    /**
+     * @brief Hashes the content of a file.
+     * @param fileName Name or path of the file.
+     * @param algorithm Hash to compute.
+     * @return Hex digest; the hash state is cached on the file and extended by appends.
+     */
+    std::string hash(const std::string& fileName, HashAlgorithm algorithm) const;
+
+    /**
+     * @brief Hashes a file, or every file below a directory in name order.
+     * @param path Path of the file or directory.
+     * @param algorithm Hash to compute.
+     * @param visit Called with the path of each file (path joined with the names below it) and its hex digest;
+     *              symbolic links below the directory are skipped.
+     */
+    void hashTree(const std::string& path, HashAlgorithm algorithm,
+                  const std::function<void(const std::string&, const std::string&)>& visit) const;
+
+    /**
+     * @brief Compares two files or trees by their Merkle hashes.
+     *
+     * Subtrees with equal hashes are skipped without being visited, so the
+     * cost depends on the number of differences rather than on the tree size.
+     * An added or deleted subtree is reported once, as its top directory.
+     *
+     * @param first Path of the first file or directory.
+     * @param second Path of the second file or directory.
+     * @param visit Called for each difference, in name order.
+     * @return Number of differences.
+     */
+    std::size_t diffTree(const std::string& first, const std::string& second,
+                         const std::function<void(const TreeChange&)>& visit) const;
+
+    /**
+     * @brief Compares two files line by line, see LineDiff.
+     * @param first Path of the old file.
+     * @param second Path of the new file.
+     * @param context Number of unchanged lines shown around each change.
+     * @param write Receives consecutive pieces of a unified diff labelled with the two paths; not called if the files are equal.
+     * @return Number of hunks.
+     */
+    std::size_t diff(const std::string& first, const std::string& second, std::size_t context,
+                     const std::function<void(std::string_view)>& write) const;
+
+    /**
+     * @brief Sorts the lines of a file, see sortLines.
+     * @param fileName Name or path of the file.
+     * @param options Order, key and uniqueness.
+     * @return Views of the lines, valid until the file is modified or removed.
+     */
+    std::vector<std::string_view> sort(const std::string& fileName, const SortOptions& options) const;
+
+    /**
+     * @brief Sorts the lines of a file into a file, which may be the input itself.
+     * @param fileName Name or path of the file.
+     * @param options Order, key and uniqueness.
+     * @param outputFile Name or path of the file to replace, created if missing.
+     * @return Number of lines written.
+     */
+    std::size_t sortToFile(const std::string& fileName, const SortOptions& options, const std::string& outputFile);
+
+    /**
+     * @brief Collapses runs of equal adjacent lines of a file, as uniq does.
+     * @param fileName Name or path of the file.
+     * @param visit Called with each distinct line (a view into the file, without its newline) and the length of its run.
+     */
+    void uniq(const std::string& fileName, const std::function<void(std::string_view, std::size_t)>& visit) const;
+
+    /**
+     * @brief Applies a sed substitution to a file in place.
+     *
+     * Replacements are collected in a PieceTable over the content, which is
+     * then compacted into the new content in a single pass; a file without
+     * matches is left untouched.
+     *
+     * @param fileName Name or path of the file.
+     * @param substitution Parsed s command.
+     * @return Number of replacements.
+     */
+    std::size_t substitute(const std::string& fileName, const Substitution& substitution);
+
+    /**
+     * @brief Applies a sed substitution to the content of a file, leaving the file unchanged.
+     * @param fileName Name or path of the file.
+     * @param substitution Parsed s command.
+     * @param write Receives consecutive pieces of the edited content.
+     * @return Number of replacements.
+     */
+    std::size_t substitute(const std::string& fileName, const Substitution& substitution,
+                           const std::function<void(std::string_view)>& write) const;
+
     /**
      * @brief Searches for a pattern in files/directories.
      * @param path Path to search in.
@@ -184,9 +578,34 @@ public:
      */
     void mv(const std::string& src, const std::string& dst, bool recursive = false);
 
+    // Links
+
+    /**
+     * @brief Creates a hard link: a new name for the content of an existing file.
+     *
+     * Both names share one content body, so a write through either is seen
+     * through the other, and removing one leaves the other intact.
+     *
+     * @param target Path of the file (a symbolic link is followed).
+     * @param linkPath Path of the new name, or an existing directory to create it in.
+     *
+     * @throws InvalidOperationException If the target is a directory.
+     * @throws FileAlreadyExists If the new name is taken.
+     */
+    void link(const std::string& target, const std::string& linkPath);
+
+    /**
+     * @brief Creates a symbolic link holding a path, resolved on each use.
+     * @param target Path stored in the link, relative to the link's directory unless absolute; need not exist.
+     * @param linkPath Path of the link, or an existing directory to create it in.
+     *
+     * @throws FileAlreadyExists If the name is taken.
+     */
+    void symlink(const std::string& target, const std::string& linkPath);
+
     /**
      * @brief Converts a directory or file structure to JSON.
-     * @param path Path to the directory.
+     * @param path Path to the directory; symbolic links below it are left out.
      * @return JSON representation of the directory.
      */
     json convertToJson(const std::string& path) const;
@@ -196,7 +615,49 @@ public:
      * @param node Directory to convert.
      * @return JSON object.
      */
-    json directoryToJson(std::shared_ptr<Directory> node) const;
+    json directoryToJson(const Directory& node) const;
+
+    /**
+     * @brief Writes a file or a whole subtree onto the host file system.
+     *
+     * If hostPath is an existing directory the node is created inside it under
+     * its own name, otherwise at hostPath itself; exporting "/" writes the
+     * children of the root. Existing host files are overwritten.
+     *
+     * Directories are created first, then the files are written by a pool of
+     * threads, each one straight from its stored content with no intermediate
+     * copy. The tree must not be modified until the call returns.
+     *
+     * Symbolic links are exported as links. An absolute target is rewritten
+     * relative to the link, so the copy points into the export rather than
+     * into the host's root; links whose target lies outside the exported
+     * tree are skipped and counted.
+     *
+     * @param path Virtual path of the file or directory.
+     * @param hostPath Destination on the host.
+     * @return Number of files, directories, links and bytes written, and of links skipped.
+     * @throws std::system_error If a host directory or file cannot be created or written.
+     */
+    ExportReport exportTree(const std::string& path, const std::string& hostPath) const;
+
+    // Usage
+
+    /**
+     * @brief Reports the storage used by a directory and its subdirectories.
+     *
+     * Each answer is O(1) because directories maintain their subtree totals.
+     *
+     * @param path Path of the directory (current directory if empty).
+     * @param summarize If true, only reports the directory itself.
+     * @return (full path, usage) pairs, subdirectories before their parents.
+     */
+    std::vector<std::pair<std::string, Usage>> du(const std::string& path, bool summarize = false) const;
+
+    /**
+     * @brief Reports the storage used by the whole file system, including estimated overhead.
+     * @return Content usage plus estimated node and metadata overhead.
+     */
+    SpaceReport df() const;
 
     // Specific
 
@@ -5,9 +5,45 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+#include "NodeMetadata.hpp"
 
 class Directory;
 
+/**
+ * @brief Storage used by a node or a whole subtree.
+ *
+ * Directories keep the usage of their subtree up to date on every mutation,
+ * so it can be read in O(1) (see Directory::getUsage).
+ */
+struct Usage
+{
+    std::size_t bytes{};        ///< File content bytes
+    std::size_t files{};        ///< Number of files
+    std::size_t directories{};  ///< Number of directories
+    std::size_t nameBytes{};    ///< Bytes used by node names
+
+    Usage& operator+=(const Usage& other) noexcept
+    {
+        bytes += other.bytes;
+        files += other.files;
+        directories += other.directories;
+        nameBytes += other.nameBytes;
+        return *this;
+    }
+
+    Usage& operator-=(const Usage& other) noexcept
+    {
+        bytes -= other.bytes;
+        files -= other.files;
+        directories -= other.directories;
+        nameBytes -= other.nameBytes;
+        return *this;
+    }
+};
+
 /**
  * @brief Abstract base class for all file system nodes (files and directories).
  *
@@ -18,17 +54,54 @@ class Directory;
  * Design:
  * - Each node keeps a weak pointer to its parent directory to avoid 
  *   circular ownership.
+ * - The name is stored once, in the node; directories index their
+ *   children by views of it.
+ * - Timestamps live in the MetadataStore side table, not in the node,
+ *   to keep nodes small.
+ * - The concrete type is recorded in a kind tag, so type checks and
+ *   downcasts (see nodeCast) need neither virtual calls nor RTTI.
+ * - A node is one directory entry. Hard links are separate File entries
+ *   sharing one content body, so each keeps its own name and parent.
  *
  * Inheritance:
  * - @see File for concrete file nodes.
  * - @see Directory for directory nodes.
+ * - @see Symlink for symbolic links.
  */
 class FileSystemNode
 {
+public:
+    /// @brief Concrete type of a node.
+    enum class Kind : std::uint8_t { FILE, DIRECTORY, SYMLINK };
+
+    /// @brief Lower-case name of a kind, e.g. "file".
+    static constexpr const char* kindName(Kind kind) noexcept
+    {
+        switch (kind) {
+            case Kind::FILE:      return "file";
+            case Kind::DIRECTORY: return "directory";
+            case Kind::SYMLINK:   return "symbolic link";
+        }
+        return "node";
+    }
+
 protected:
     /// Weak pointer to parent directory (avoids cyclic references).
     std::weak_ptr<Directory> parent{};
 
+    /// Name of the node, immutable so directory indexes can refer to it.
+    const std::string nodeName;
+
+    /// Concrete type of the node, fixed at construction.
+    const Kind nodeKind;
+
+    /**
+     * @brief Constructs a node with the given name.
+     * @param name Name of the node.
+     * @param kind Concrete type of the derived class.
+     */
+    FileSystemNode(const std::string& name, Kind kind) : nodeName{name}, nodeKind{kind} { MetadataStore::instance().onCreate(this); }
+
 public:
     /**
      * @brief Sets the parent directory of this node.
@@ -36,21 +109,34 @@ public:
      */
     void setParent(std::shared_ptr<Directory> p) { parent = p; }
 
+    /**
+     * @brief Gets the directory holding this node.
+     * @return The parent, or null for the root and for nodes that were removed.
+     */
+    std::shared_ptr<Directory> getParent() const noexcept { return parent.lock(); }
+
     /**
      * @brief Gets the size of the node.
      * 
      * - For a file, returns its content size (in bytes).
-     * - For a directory, returns the number of children.
+     * - For a directory, returns the number of files and directories in its whole subtree.
+     * - For a symbolic link, returns the length of its target path.
      * 
      * @return The size of the node.
      */
     virtual std::size_t getSize() const = 0;
 
+    /**
+     * @brief Gets the storage used by this node, including its subtree for directories.
+     * @return Content bytes, node counts and name bytes.
+     */
+    virtual Usage getUsage() const = 0;
+
     /**
      * @brief Gets the name of the node.
-     * @return Node name as a string.
+     * @return Node name, valid for the lifetime of the node.
      */
-    virtual std::string getName() const = 0;
+    const std::string& getName() const noexcept { return nodeName; }
 
     /**
      * @brief Computes the full path of this node from the root.
@@ -58,14 +144,58 @@ public:
      */
     virtual std::string getFullPath() const = 0;
 
+    /**
+     * @brief Gets the concrete type of the node.
+     * @return The kind tag.
+     */
+    Kind kind() const noexcept { return nodeKind; }
+
     /**
      * @brief Checks if this node is a directory.
      * @return True if it is a directory, false if it is a file.
      */
-    virtual bool isDirectory() const noexcept = 0;
+    bool isDirectory() const noexcept { return nodeKind == Kind::DIRECTORY; }
+
+    /**
+     * @brief Checks if this node is a symbolic link.
+     * @return True for symbolic links.
+     */
+    bool isSymlink() const noexcept { return nodeKind == Kind::SYMLINK; }
+
+    /**
+     * @brief Gets the creation and modification times of the node.
+     * @return Timestamps from the MetadataStore.
+     */
+    NodeMetadata getMetadata() const { return MetadataStore::instance().get(this); }
 
     /**
      * @brief Virtual destructor for safe polymorphic deletion.
      */
-    virtual ~FileSystemNode() = default; // implicitly noexcept
+    virtual ~FileSystemNode() { MetadataStore::instance().onDestroy(this); }
 };
+
+/**
+ * @brief Downcasts a node to its concrete type after checking the kind tag.
+ *
+ * A static cast guarded by FileSystemNode::kind(): no RTTI, and no reference
+ * count traffic since it works on references.
+ *
+ * @tparam T File, Directory or Symlink.
+ * @param node Node to cast.
+ * @return The node as T.
+ * @throws std::runtime_error If the node is not a T.
+ */
+template <typename T>
+T& nodeCast(FileSystemNode& node)
+{
+    if (node.kind() != T::staticKind) throw std::runtime_error(std::string{"Expected a "} + FileSystemNode::kindName(T::staticKind));
+    return static_cast<T&>(node);
+}
+
+/// @copydoc nodeCast(FileSystemNode&)
+template <typename T>
+const T& nodeCast(const FileSystemNode& node)
+{
+    if (node.kind() != T::staticKind) throw std::runtime_error(std::string{"Expected a "} + FileSystemNode::kindName(T::staticKind));
+    return static_cast<const T&>(node);
+}
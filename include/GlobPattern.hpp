@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Shell-style pattern for a single path component.
+ *
+ * Supports `*` (any run of characters), `?` (any one character) and bracket
+ * expressions such as `[abc]`, `[a-z]` and `[!0-9]` (`^` also negates).
+ * A backslash makes the next character literal. The component `**` is
+ * recognised as the recursive wildcard; matching it is left to the caller.
+ */
+class GlobPattern
+{
+public:
+    /**
+     * @brief Compiles a pattern.
+     * @param pattern One path component, without '/'.
+     */
+    explicit GlobPattern(std::string_view pattern);
+
+    /**
+     * @brief Checks whether a name matches the pattern.
+     * @param name Name to test.
+     */
+    bool matches(std::string_view name) const noexcept;
+
+    /// @brief Longest literal text every match starts with, escapes removed.
+    const std::string& literalPrefix() const noexcept { return prefix; }
+
+    /// @brief True if the pattern has no wildcards, i.e. matches exactly literalPrefix().
+    bool isLiteral() const noexcept { return literal; }
+
+    /// @brief True for the recursive wildcard `**`.
+    bool isRecursive() const noexcept { return recursive; }
+
+    /**
+     * @brief Checks whether text contains an unescaped wildcard.
+     * @param text Pattern text, possibly with several components.
+     */
+    static bool hasWildcard(std::string_view text) noexcept;
+
+    /**
+     * @brief Removes the backslash escapes from pattern text.
+     * @param text Pattern text.
+     * @return The literal text.
+     */
+    static std::string unescape(std::string_view text);
+
+private:
+    /**
+     * @brief Matches a bracket expression against one character.
+     * @param pos Position of the opening '['; on success moved past the closing ']'.
+     * @param c Character to test.
+     * @param matched Receives whether c is in the set.
+     * @return False if the bracket is not closed, in which case '[' is literal.
+     */
+    bool matchBracket(std::size_t& pos, char c, bool& matched) const noexcept;
+
+private:
+    std::string text;       ///< Pattern as given
+    std::string prefix;     ///< Literal prefix, unescaped
+    bool literal{true};     ///< No wildcards at all
+    bool recursive{false};  ///< The pattern is exactly "**"
+};
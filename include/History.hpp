@@ -0,0 +1,103 @@
+#pragma once
+
+#include "MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief The command lines typed into the shell, kept across sessions.
+ *
+ * Lines are appended to a text file, one per line, and the end offset of each
+ * is appended to an index file next to it (`<path>.idx`: an 8-byte magic, the
+ * entry count, then one 64-bit offset per entry). Both files are memory mapped
+ * (see MappedFile), so opening costs the same for any number of entries and
+ * an entry is reached in O(1) by its number. The count is stored last, so an
+ * entry cut short by a crash is simply not there; an index that is missing or
+ * does not match the text file is rebuilt from it.
+ *
+ * search() is served from a trigram index built lazily on first use and
+ * extended as lines are added. It maps each trigram (hashed into a fixed
+ * number of buckets) to the blocks of consecutive entries containing it, so
+ * a query only scans the few blocks holding all of its trigrams, newest
+ * first. Queries shorter than a trigram scan the entries back from the
+ * newest, where a match is usually near.
+ *
+ * Not thread-safe.
+ */
+class History
+{
+public:
+    /**
+     * @brief Returns the shell's history.
+     */
+    static History& instance();
+
+    /// @brief Constructs an empty history that is not saved.
+    History();
+
+    /**
+     * @brief Switches to the history saved in a file, creating it if needed.
+     * @param path Path of the history file.
+     * @throws std::runtime_error If the file cannot be opened, or another shell uses it.
+     */
+    void open(const std::string& path);
+
+    /**
+     * @brief Appends a line.
+     * @param line The command line; lines with '\n' or '\0' are ignored.
+     */
+    void add(std::string_view line);
+
+    /// @brief Number of entries.
+    std::size_t size() const noexcept { return count(); }
+
+    /**
+     * @brief Returns an entry; the view is valid until the next add().
+     * @param index Position of the entry, 0 for the oldest.
+     */
+    std::string_view entry(std::size_t index) const noexcept;
+
+    /**
+     * @brief Finds the newest entry containing a text, as reverse search does.
+     * @param text Text to find, matched case-sensitively.
+     * @param before Only entries before this position are considered.
+     * @return Position of the entry, or nothing.
+     */
+    std::optional<std::size_t> search(std::string_view text, std::size_t before);
+
+    /**
+     * @brief Replaces the history references of a line with the entries they name.
+     *
+     * `!!` is the last entry, `!n` entry n (numbered from 1, as history prints
+     * them), `!-n` the n-th last and `!text` the last one starting with text.
+     * A '!' inside single quotes, escaped, or followed by a blank, '=', '(' or
+     * a quote stays as it is.
+     *
+     * @param line The command line.
+     * @return The line with references replaced.
+     * @throws InvalidOperationException If a reference names no entry.
+     */
+    std::string expand(const std::string& line) const;
+
+private:
+    std::uint64_t count() const noexcept;
+    std::uint64_t endOffset(std::size_t index) const noexcept;
+
+    /// @brief Writes a fresh index for the lines of the text file.
+    void rebuildIndex();
+
+    /// @brief Adds the entries not yet in the search index to it.
+    void updateSearchIndex();
+
+    std::unique_ptr<MappedFile> lines;    ///< Entries, each followed by '\n'
+    std::unique_ptr<MappedFile> offsets;  ///< Header, then the end offset of each entry in lines
+
+    std::vector<std::vector<std::uint32_t>> gramBlocks;  ///< Blocks containing each trigram bucket, ascending
+    std::size_t indexed{};                               ///< Entries in gramBlocks
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Line-by-line comparison of two texts, printed as a unified diff.
+ *
+ * Uses Myers' O(ND) algorithm in its linear-space form: the edit script is
+ * found by recursively splitting both sequences at the middle snake of an
+ * optimal path, so memory grows with the input, not with the number of edits.
+ * When the search gets expensive it settles for the furthest-reaching
+ * diagonal, as GNU diff does, so very different inputs still finish quickly
+ * (with a valid but possibly non-minimal diff).
+ *
+ * Before any line is looked at, the common leading and trailing bytes are
+ * skipped and only the lines in between (plus the context needed around them)
+ * are split into views of the texts and interned to integer ids. Two large,
+ * mostly equal files therefore cost a memcmp plus work proportional to the
+ * region that differs. The texts must outlive the LineDiff.
+ */
+class LineDiff
+{
+public:
+    /**
+     * @brief Compares two texts.
+     * @param first Old text.
+     * @param second New text.
+     * @param context Number of unchanged lines shown around each change.
+     */
+    LineDiff(std::string_view first, std::string_view second, std::size_t context = 3);
+
+    /// @brief Whether the texts have the same lines.
+    bool identical() const noexcept { return changes.empty(); }
+
+    /// @brief Number of hunks writeUnified prints.
+    std::size_t hunkCount() const noexcept;
+
+    /**
+     * @brief Writes the hunks in unified format, without the ---/+++ header.
+     * @param write Receives consecutive pieces of the output.
+     */
+    void writeUnified(const std::function<void(std::string_view)>& write) const;
+
+private:
+    /// @brief A run of lines of the first text replaced by a run of lines of the second.
+    struct Change
+    {
+        std::size_t first;
+        std::size_t firstCount;
+        std::size_t second;
+        std::size_t secondCount;
+    };
+
+    /// @brief Splits the texts into line views and interns them.
+    void load(std::string_view first, std::string_view second);
+
+    /// @brief Marks the changed lines of ids[first, firstEnd) against ids[second, secondEnd).
+    void compare(std::ptrdiff_t first, std::ptrdiff_t firstEnd, std::ptrdiff_t second, std::ptrdiff_t secondEnd);
+
+    /// @brief Finds a point on a (near) optimal edit path through the given box.
+    std::pair<std::ptrdiff_t, std::ptrdiff_t> split(std::ptrdiff_t first, std::ptrdiff_t firstEnd,
+                                                    std::ptrdiff_t second, std::ptrdiff_t secondEnd);
+
+    /**
+     * @brief Slides runs of changed lines over equal neighbours so that runs merge where possible.
+     * @param ids Line ids of the lines the runs may move over, in the text whose runs are moved.
+     * @param size Number of those lines.
+     * @param changed Marks of those lines; the marks just before and after them must be clear.
+     * @param otherChanged Marks of the other text, at the same starting line.
+     */
+    static void shiftBoundaries(const std::uint32_t* ids, std::ptrdiff_t size, char* changed, const char* otherChanged) noexcept;
+
+    /// @brief Turns the changed-line marks into runs.
+    void collectChanges();
+
+    /// @brief Returns the index of the last change in the hunk starting with change @p begin.
+    std::size_t hunkEnd(std::size_t begin) const noexcept;
+
+    const std::size_t context;
+
+    // Lines of the compared window of each text, with their trailing newline.
+    std::vector<std::string_view> firstLines;
+    std::vector<std::string_view> secondLines;
+    std::size_t firstOffset{};   ///< Number of lines of the first text before its window
+    std::size_t secondOffset{};  ///< Number of lines of the second text before its window
+
+    // Interned line ids and changed-line marks, used while comparing.
+    // The marks hold one unchanged sentinel before and after the lines, so line i is at i + 1.
+    std::vector<std::uint32_t> firstIds;
+    std::vector<std::uint32_t> secondIds;
+    std::vector<char> firstChanged;
+    std::vector<char> secondChanged;
+
+    // Furthest-reaching x per diagonal of the forward and backward searches.
+    std::vector<std::ptrdiff_t> forward;
+    std::vector<std::ptrdiff_t> backward;
+    std::ptrdiff_t diagonalOffset{};
+    std::ptrdiff_t costLimit{};
+
+    std::vector<Change> changes;
+};
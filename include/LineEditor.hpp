@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Reads command lines, with tab completion and reverse search when attached to a terminal.
+ *
+ * On a terminal, input is read in raw mode one key at a time. Supported keys
+ * are printable characters, Backspace, Tab (completion), Ctrl-R (reverse
+ * search), Enter, Ctrl-C (discard the line) and Ctrl-D (end of input on an
+ * empty line); other escape sequences are ignored. When stdin is not a terminal, or termios is not
+ * available, lines are read with std::getline and nothing changes.
+ */
+class LineEditor
+{
+public:
+    /// @brief Result of completing the end of a line.
+    struct Completion
+    {
+        std::string insertion;                ///< Text to append to the line
+        std::vector<std::string> candidates;  ///< Alternatives to list when there is nothing to insert
+    };
+
+    /// @brief Computes the completion of a line, given the whole line typed so far.
+    using Completer = std::function<Completion(const std::string&)>;
+
+    /// @brief A line found by reverse search.
+    struct Match
+    {
+        std::string line;        ///< The line
+        std::size_t position{};  ///< Where it was found; older lines are searched before it
+    };
+
+    /// @brief Finds the newest line containing a query among the lines before a position.
+    using Searcher = std::function<std::optional<Match>(std::string_view, std::size_t)>;
+
+    /**
+     * @brief Constructs an editor.
+     * @param completer Called when Tab is pressed.
+     * @param searcher Called while searching with Ctrl-R; without it Ctrl-R is ignored.
+     */
+    explicit LineEditor(Completer completer, Searcher searcher = {}) : completer{std::move(completer)}, searcher{std::move(searcher)} { }
+
+    /**
+     * @brief Prints a prompt and reads one line.
+     * @param prompt Prompt to print (and reprint after listing candidates).
+     * @param line Receives the line, without the newline.
+     * @return False at end of input.
+     */
+    bool readLine(const std::string& prompt, std::string& line);
+
+    /// @brief Whether stdin is a terminal, i.e. lines are typed rather than piped or replayed.
+    static bool interactive() noexcept;
+
+private:
+    /**
+     * @brief Reads one line key by key in raw terminal mode.
+     * @param prompt Prompt to print.
+     * @param line Receives the line.
+     * @return False at end of input.
+     */
+    bool readRaw(const std::string& prompt, std::string& line);
+
+    /**
+     * @brief Handles Tab: appends the completion or lists the candidates.
+     * @param prompt Prompt to reprint after a listing.
+     * @param line Line being edited.
+     */
+    void complete(const std::string& prompt, std::string& line);
+
+    /**
+     * @brief Handles Ctrl-R: searches incrementally as the query is typed.
+     *
+     * Ctrl-R again finds the next older match, Backspace shortens the query,
+     * Enter runs the match and Ctrl-G or Ctrl-C go back to the line as it
+     * was; any other key leaves the match on the line for editing.
+     *
+     * @param prompt Prompt to reprint when the search ends.
+     * @param line Line being edited; receives the match.
+     * @return True if the line is to be run at once.
+     */
+    bool reverseSearch(const std::string& prompt, std::string& line);
+
+private:
+    Completer completer;
+    Searcher searcher;
+};
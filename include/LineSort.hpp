@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+/// @brief Flags of sortLines, as those of sort.
+struct SortOptions
+{
+    bool reverse{};  ///< Descending order
+    bool numeric{};  ///< Compares the leading numbers of the lines instead of their bytes
+    bool unique{};   ///< Keeps only the first of the lines with equal keys
+};
+
+/**
+ * @brief Sorts the lines of a text, as sort does in the C locale.
+ *
+ * Lines are views into the text (without their '\n'), so nothing is copied
+ * and the text must outlive the result. Plain keys compare bytes as unsigned;
+ * each view is sorted next to its first 8 bytes packed into an integer, so
+ * most comparisons never touch the text.
+ * Numeric keys are the optional blanks, '-' sign, digits and fraction at the
+ * start of a line, compared digit by digit so any length is exact; a line
+ * without a number counts as 0. Lines with equal keys are ordered by their
+ * bytes unless unique is set, in which case the first of them in the text is
+ * kept.
+ *
+ * The sort is a stable merge sort. Large inputs are cut into one run per
+ * hardware thread, the runs are sorted concurrently, and each round of
+ * pairwise merges is split at co-ranked positions so that every thread
+ * takes an equal share of the output.
+ *
+ * @param text Text whose lines are sorted; a last line without '\n' counts.
+ * @param options Order and key.
+ * @return The sorted lines.
+ */
+std::vector<std::string_view> sortLines(std::string_view text, const SortOptions& options);
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A growable file mapped into memory, for append-only logs.
+ *
+ * The file is mapped shared, so bytes written through data() are in the file
+ * as soon as they are stored and survive the process being killed. Growing
+ * beyond the capacity extends the file geometrically and maps it again, which
+ * invalidates pointers into the old mapping. The file is held under an
+ * exclusive advisory lock while open, and is cut back to size() when closed.
+ *
+ * A default-constructed MappedFile keeps its bytes on the heap and persists
+ * nothing. Where mmap is not available, opening a file always fails.
+ */
+class MappedFile
+{
+public:
+    /// @brief Constructs an empty buffer that is not backed by a file.
+    MappedFile() = default;
+
+    /**
+     * @brief Opens or creates a file and maps all of it.
+     * @param path Path of the file.
+     * @throws std::runtime_error If the file cannot be opened or mapped, or another process holds it.
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    char* data() noexcept { return bytes; }
+    const char* data() const noexcept { return bytes; }
+
+    /// @brief Number of bytes in use; when opened, the size of the file.
+    std::size_t size() const noexcept { return length; }
+
+    /**
+     * @brief Sets the number of bytes in use, growing the mapping if needed.
+     *
+     * Bytes added by growing read as zero.
+     *
+     * @param size New number of bytes in use.
+     * @throws std::runtime_error If the file cannot be extended or mapped again.
+     */
+    void resize(std::size_t size);
+
+    /// @brief Whether the bytes are backed by a file.
+    bool persistent() const noexcept { return fd >= 0; }
+
+private:
+    /// @brief Maps the first `size` bytes of the file, replacing the current mapping.
+    void map(std::size_t size);
+
+    int fd{-1};
+    char* bytes{nullptr};
+    std::size_t length{};
+    std::size_t capacity{};
+    std::vector<char> memory;  ///< Storage when there is no file
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Latency histogram with log-linear buckets.
+ *
+ * Values (nanoseconds) below 8 get an exact bucket each. Every power-of-two
+ * range above that is split into 8 linear sub-buckets, so any reported
+ * quantile is within 12.5% of the true value while the whole 64-bit range
+ * fits in a fixed array.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t subBucketBits{3};
+    static constexpr std::size_t subBuckets{std::size_t{1} << subBucketBits};
+    static constexpr std::size_t bucketCount{(64 - subBucketBits + 1) * subBuckets};
+
+    /**
+     * @brief Maps a value to its bucket.
+     * @param value Latency in nanoseconds.
+     * @return Bucket index in [0, bucketCount).
+     */
+    static std::size_t bucketIndex(std::uint64_t value) noexcept;
+
+    /**
+     * @brief Largest value that falls into a bucket.
+     * @param index Bucket index.
+     * @return Inclusive upper bound in nanoseconds.
+     */
+    static std::uint64_t bucketUpperBound(std::size_t index) noexcept;
+
+    /// @brief Records a single latency sample (nanoseconds).
+    void record(std::uint64_t value) noexcept;
+
+    /// @brief Adds bucket counts and totals of another histogram.
+    void merge(const LatencyHistogram& other) noexcept;
+
+    /// @brief Adds one bucket worth of samples, used when aggregating shards.
+    void addBucket(std::size_t index, std::uint64_t samples) noexcept { counts[index] += samples; }
+
+    /// @brief Adds to the sample count, sum and max, used when aggregating shards.
+    void addTotals(std::uint64_t samples, std::uint64_t sum, std::uint64_t max) noexcept;
+
+    /**
+     * @brief Estimates a quantile.
+     * @param q Quantile in [0, 1], e.g. 0.99.
+     * @return Upper bound of the bucket holding the quantile, clamped to the max sample.
+     */
+    std::uint64_t quantile(double q) const noexcept;
+
+    std::uint64_t count() const noexcept { return total; }
+    std::uint64_t sum() const noexcept { return totalSum; }
+    std::uint64_t max() const noexcept { return maxValue; }
+    const std::array<std::uint64_t, bucketCount>& buckets() const noexcept { return counts; }
+
+private:
+    std::array<std::uint64_t, bucketCount> counts{};
+    std::uint64_t total{};
+    std::uint64_t totalSum{};
+    std::uint64_t maxValue{};
+};
+
+/**
+ * @brief Process-wide registry of per-command execution metrics.
+ *
+ * Records, for every command name, the number of executions, the number of
+ * failures per exception kind and a latency histogram.
+ *
+ * Design:
+ * - Each recording thread owns a shard; recording only touches that shard
+ *   with relaxed atomic loads/stores, so it takes no lock and never contends.
+ * - Command and error kind names are interned once under a mutex and then
+ *   cached per shard.
+ * - Readers (stats, Prometheus export) aggregate all shards on demand.
+ */
+class MetricsRegistry
+{
+public:
+    /// @brief Aggregated metrics of a single command.
+    struct CommandStats
+    {
+        std::string name;
+        std::uint64_t count{};
+        std::vector<std::pair<std::string, std::uint64_t>> errors;  ///< Failures per exception kind
+        LatencyHistogram latency;
+
+        std::uint64_t errorCount() const noexcept;
+    };
+
+    /// @brief Maximum number of distinct command names; the rest are folded into "other".
+    static constexpr std::size_t maxSeries{128};
+
+    /// @brief Maximum number of distinct error kinds; the rest are folded into "other".
+    static constexpr std::size_t maxErrorKinds{32};
+
+    /**
+     * @brief Returns the process-wide registry.
+     */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Records one command execution on the calling thread's shard.
+     * @param command Command name.
+     * @param latencyNs Execution time in nanoseconds.
+     * @param errorKind Exception kind if the command failed, nullptr otherwise.
+     */
+    void record(const std::string& command, std::uint64_t latencyNs, const char* errorKind = nullptr);
+
+    /**
+     * @brief Aggregates all shards.
+     * @return Per-command statistics sorted by command name.
+     */
+    std::vector<CommandStats> snapshot() const;
+
+    /**
+     * @brief Writes all metrics in the Prometheus text exposition format.
+     *
+     * Latency histograms always have the same cumulative buckets, one per
+     * power of two of nanoseconds from 1us to about 69s, and +Inf.
+     *
+     * @param out Stream to write to.
+     */
+    void writePrometheus(std::ostream& out) const;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+private:
+    struct Series;
+    struct Shard;
+
+    MetricsRegistry() = default;
+
+    /// @brief Returns the calling thread's shard, registering it on first use.
+    Shard& localShard();
+
+    /// @brief Interns a name into the given table, returns its index.
+    std::size_t intern(std::vector<std::string>& table, std::size_t limit, const std::string& name);
+
+private:
+    mutable std::mutex mutex;                    ///< Guards the name tables and the shard list
+    std::vector<std::string> seriesNames;        ///< Index -> command name
+    std::vector<std::string> errorKindNames;     ///< Index -> error kind
+    std::vector<std::unique_ptr<Shard>> shards;  ///< All shards ever created, never freed
+};
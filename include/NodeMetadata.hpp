@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class FileSystemNode;
+
+/**
+ * @brief Cheap wall clock for timestamps that do not need sub-command precision.
+ *
+ * now() returns a cached time point, so stamping many nodes costs no clock
+ * syscall each. The shell refreshes the cache once per command with tick();
+ * code running outside the shell loop should call tick() itself.
+ */
+class CoarseClock
+{
+public:
+    using time_point = std::chrono::system_clock::time_point;
+
+    /**
+     * @brief Returns the cached time, refreshing it first if it was never set.
+     */
+    static time_point now() noexcept;
+
+    /**
+     * @brief Refreshes the cached time from the system clock.
+     */
+    static void tick() noexcept;
+
+private:
+    static inline std::atomic<std::int64_t> cached{0};  ///< system_clock ticks since epoch, 0 if never set
+};
+
+/// @brief Timestamps of a node.
+struct NodeMetadata
+{
+    CoarseClock::time_point created;   ///< When the node was created
+    CoarseClock::time_point modified;  ///< Last content change (files) or entry change (directories)
+};
+
+/**
+ * @brief Cold side table holding the metadata of every live node.
+ *
+ * Timestamps are rarely read on hot paths, so they are kept out of the node
+ * objects, keyed by node address. Nodes register themselves on construction
+ * and unregister on destruction (see FileSystemNode).
+ *
+ * The table is a flat linear-probing hash (at most half full, backward-shift
+ * deletion), so registering a node costs no allocation of its own.
+ *
+ * Like the tree itself, the store is not synchronized.
+ */
+class MetadataStore
+{
+public:
+    /**
+     * @brief Returns the process-wide store.
+     */
+    static MetadataStore& instance();
+
+    /// @brief Registers a new node, stamping both times with CoarseClock::now().
+    void onCreate(const FileSystemNode* node);
+
+    /// @brief Stamps the modification time of a node with CoarseClock::now().
+    void onModify(const FileSystemNode* node);
+
+    /// @brief Forgets a node.
+    void onDestroy(const FileSystemNode* node) noexcept;
+
+    /**
+     * @brief Reads the metadata of a node.
+     * @param node Live node.
+     * @return Its timestamps, zero time points if the node is unknown.
+     */
+    NodeMetadata get(const FileSystemNode* node) const;
+
+    /// @brief Bytes held by the table.
+    std::size_t memoryUsage() const noexcept { return slots.capacity() * sizeof(Slot); }
+
+    MetadataStore(const MetadataStore&) = delete;
+    MetadataStore& operator=(const MetadataStore&) = delete;
+
+private:
+    MetadataStore() = default;
+
+    /// @brief One table slot; a null key marks a free slot.
+    struct Slot
+    {
+        const FileSystemNode* key{};
+        NodeMetadata metadata;
+    };
+
+    /// @brief Home slot of a key.
+    std::size_t home(const FileSystemNode* node) const noexcept;
+
+    /// @brief Slot holding the key, or the free slot where it would go.
+    std::size_t probe(const FileSystemNode* node) const noexcept;
+
+    /// @brief Doubles the table and reinserts every entry.
+    void grow();
+
+private:
+    std::vector<Slot> slots;  ///< Power of two sized, empty until the first node
+    std::size_t used{};       ///< Occupied slots
+};
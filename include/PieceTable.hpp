@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Edit buffer over an unchanged text, as used by editors.
+ *
+ * The edited text is a sequence of pieces, each a range of either the
+ * original text or an append-only buffer holding every inserted byte. A
+ * replacement splits at most two pieces and appends the new bytes, so its cost
+ * does not depend on the size of the text, and nothing is moved until
+ * toString() builds the result in one pass.
+ *
+ * A cursor remembers the piece after the last edit. Edits made front to back,
+ * as a search-and-replace does, therefore find their piece in O(1) and only
+ * ever add pieces at the end of the list. The original text must outlive the
+ * table.
+ */
+class PieceTable
+{
+public:
+    /**
+     * @brief Starts editing a text.
+     * @param original Text to edit; it is not modified or copied.
+     */
+    explicit PieceTable(std::string_view original);
+
+    /**
+     * @brief Replaces a range of the edited text.
+     * @param offset Position of the range in the edited text.
+     * @param length Number of bytes removed.
+     * @param text Bytes inserted in their place.
+     * @throws std::out_of_range If the range runs past the end of the text.
+     */
+    void replace(std::size_t offset, std::size_t length, std::string_view text);
+
+    /// @brief Size of the edited text.
+    std::size_t size() const noexcept { return totalSize; }
+
+    /**
+     * @brief Visits the edited text piece by piece, without building it.
+     * @param visit Receives consecutive ranges of the edited text.
+     */
+    void forEachPiece(const std::function<void(std::string_view)>& visit) const;
+
+    /**
+     * @brief Builds the edited text.
+     * @return The text, allocated once at its final size.
+     */
+    std::string toString() const;
+
+private:
+    /// @brief A range of the original text or of the added buffer.
+    struct Piece
+    {
+        bool added{};
+        std::size_t offset{};
+        std::size_t length{};
+    };
+
+    /// @brief Moves the cursor to the piece holding the byte at offset (past the last piece for the end).
+    void seek(std::size_t offset) noexcept;
+
+    std::string_view view(const Piece& piece) const noexcept;
+
+    std::string_view original;
+    std::string added;
+    std::vector<Piece> pieces;
+    std::size_t totalSize{};
+
+    std::size_t cursorPiece{};   ///< Index of the piece the cursor is on
+    std::size_t cursorOffset{};  ///< Position of that piece in the edited text
+};
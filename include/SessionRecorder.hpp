@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief Logs executed command lines with timestamps for later replay.
+ *
+ * Log format, one command per line:
+ * @code
+ * # minishell session
+ * <microseconds since recording started>\t<command line>
+ * @endcode
+ * Lines starting with '#' are comments.
+ *
+ * @see SessionReplayer for re-executing a log.
+ */
+class SessionRecorder
+{
+public:
+    /**
+     * @brief Returns the process-wide recorder.
+     */
+    static SessionRecorder& instance();
+
+    /**
+     * @brief Checks whether command lines are currently being recorded.
+     */
+    static bool enabled() noexcept { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Starts recording into a file, truncating it.
+     * @param file Path of the session log.
+     * @throws InvalidOperationException if already recording.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    void start(const std::string& file);
+
+    /**
+     * @brief Stops recording and closes the log.
+     * @throws InvalidOperationException if not recording.
+     */
+    void stop();
+
+    /**
+     * @brief Appends a command line to the log, if recording.
+     * @param line The command line as typed.
+     */
+    void record(const std::string& line);
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+private:
+    SessionRecorder() = default;
+
+private:
+    static inline std::atomic<bool> active{false};
+
+    std::mutex mutex;  ///< Guards the log stream
+    std::ofstream out;
+    std::chrono::steady_clock::time_point startTime;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Re-executes a session log written by SessionRecorder against a fresh shell.
+ *
+ * Command output is discarded while replaying. At the end a report with the
+ * overall throughput and the latency distribution per command is printed.
+ */
+class SessionReplayer
+{
+public:
+    /// @brief Replay pacing.
+    enum class Speed
+    {
+        MAX,   ///< Execute commands back to back
+        REAL   ///< Keep the recorded gaps between commands
+    };
+
+    /**
+     * @brief Loads a session log.
+     * @param file Path of the session log.
+     * @param speed Replay pacing.
+     * @throws std::runtime_error if the file cannot be opened or is malformed.
+     */
+    SessionReplayer(const std::string& file, Speed speed);
+
+    /**
+     * @brief Replays all commands and writes the report.
+     * @param report Stream receiving the throughput and latency report.
+     */
+    void run(std::ostream& report);
+
+private:
+    struct Entry
+    {
+        std::uint64_t offsetUs;  ///< Recorded time since session start
+        std::string line;        ///< Command line
+    };
+
+    std::vector<Entry> entries;
+    Speed speed;
+};
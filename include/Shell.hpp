@@ -2,6 +2,7 @@
 
 #include "FileSystemManager.hpp"
 #include "CommandParser.hpp"
+#include "LineEditor.hpp"
 #include <csignal>
 
 class Shell
@@ -12,4 +13,36 @@ private:
 
 public:
     void run();
-};
\ No newline at end of file
+
+    /**
+     * @brief Parses and executes a single command line.
+     *
+     * Unquoted wildcard arguments are expanded against the file system first,
+     * and kept as typed when nothing matches; for commands that batch their
+     * operands the matches are streamed in batches. Errors are reported on
+     * stderr. Every executed command is recorded in the MetricsRegistry
+     * together with its latency and, on failure, its error kind, and logged by
+     * the SessionRecorder while a recording is on.
+     *
+     * @param input The command line.
+     * @return True if the command ran successfully, false otherwise.
+     */
+    bool execute(const std::string& input);
+
+    /**
+     * @brief Completes the last word of a partially typed line.
+     *
+     * The first word completes to command names, later words to paths.
+     * Completed text is backslash-escaped unless the word is inside quotes.
+     *
+     * @param line The line typed so far.
+     * @return Text to append, or the candidates when the completion is ambiguous.
+     */
+    LineEditor::Completion complete(const std::string& line) const;
+
+private:
+    /**
+     * @brief Prints the events queued for the shell's watches since the last call.
+     */
+    void printWatchEvents();
+};
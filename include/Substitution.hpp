@@ -0,0 +1,73 @@
+#pragma once
+
+#include "PieceTable.hpp"
+#include "../utility/Utils.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A sed substitution command, `s/pattern/replacement/flags`.
+ *
+ * Any character after the `s` may serve as delimiter. The pattern is a POSIX
+ * basic (or, if requested, extended) regular expression matched line by line;
+ * the replacement may refer to the match with `&` and to groups with `\1` to
+ * `\9`. Flags are `g` (every match on a line) and a number n (the n-th match,
+ * and with `g` every one after it). Without flags the first match of each
+ * line is replaced.
+ *
+ * A pattern without regex operators is searched as a literal with KMPSolver
+ * over the whole text, visiting only the lines that contain a match; other
+ * patterns go through std::regex one line at a time. Either way the
+ * replacements are recorded front to back in a PieceTable over the text.
+ */
+class Substitution
+{
+public:
+    /**
+     * @brief Parses a substitution command.
+     * @param script The command, e.g. "s/old/new/g".
+     * @param extended Whether the pattern is an extended rather than a basic regular expression.
+     *
+     * @throws InvalidOperationException If the command, the pattern or a group reference is malformed.
+     */
+    explicit Substitution(std::string_view script, bool extended = false);
+
+    /**
+     * @brief Replaces the matches in a text.
+     * @param text Text to search.
+     * @param edits Edit buffer over the same text, without earlier edits; receives the replacements.
+     * @return Number of replacements.
+     */
+    std::size_t apply(std::string_view text, PieceTable& edits) const;
+
+    /// @brief Whether the pattern is searched as a literal string.
+    bool isLiteral() const noexcept { return searcher.has_value(); }
+
+private:
+    /// @brief Piece of the replacement: literal text, or a group of the match (0 for all of it).
+    struct Part
+    {
+        enum class Type : std::uint8_t { TEXT, GROUP };
+
+        Type type{};
+        std::string text;
+        std::size_t group{};
+    };
+
+    std::size_t applyLiteral(std::string_view text, PieceTable& edits) const;
+    std::size_t applyRegex(std::string_view text, PieceTable& edits) const;
+
+    std::string pattern;
+    std::vector<Part> replacement;
+    bool global{false};
+    std::size_t occurrence{1};  ///< First match of a line to replace, counting from 1
+
+    std::optional<utility::KMPSolver> searcher;  ///< Set for a literal pattern
+    std::string literalReplacement;              ///< Replacement of a literal pattern, with & expanded
+    std::optional<std::regex> regex;             ///< Set for any other pattern
+};
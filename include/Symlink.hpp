@@ -0,0 +1,73 @@
+#pragma once
+
+#include "FileSystemNode.hpp"
+
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief A symbolic link: a node holding a path to another node.
+ *
+ * The target is stored verbatim and resolved on use, relative to the
+ * directory holding the link unless it is absolute; it may dangle.
+ *
+ * Each link remembers the node it last resolved to, tagged with the
+ * structure generation of the file system (see Directory::generation).
+ * Any node added or removed anywhere bumps the generation, so the cached
+ * target is only reused while no path can have changed meaning; a chain of
+ * links then resolves in O(1).
+ */
+class Symlink : public FileSystemNode
+{
+public:
+    /// @brief Kind tag of every Symlink, see nodeCast.
+    static constexpr Kind staticKind{Kind::SYMLINK};
+
+    /**
+     * @brief Constructs a symbolic link.
+     * @param name Name of the link.
+     * @param target Path the link points to.
+     */
+    Symlink(const std::string& name, const std::string& target) : FileSystemNode{name, staticKind}, linkTarget{target} { }
+
+    /**
+     * @brief Gets the length of the target path.
+     * @return Size of the target, as reported by lstat.
+     */
+    virtual std::size_t getSize() const noexcept override { return linkTarget.size(); }
+
+    /**
+     * @brief Gets the storage used by this link.
+     * @return One file, with the name and the target counted as name bytes.
+     */
+    virtual Usage getUsage() const noexcept override { return {0, 1, 0, nodeName.size() + linkTarget.size()}; }
+
+    /**
+     * @brief Gets the target path.
+     * @return The path as given when the link was created.
+     */
+    const std::string& target() const noexcept { return linkTarget; }
+
+    /**
+     * @brief Returns the node the link last resolved to, if that is still valid.
+     * @return The final target (never a link), or null if it must be resolved again.
+     */
+    std::shared_ptr<FileSystemNode> cachedTarget() const noexcept;
+
+    /**
+     * @brief Remembers the node the link resolves to under the current generation.
+     * @param node Final target of the link.
+     */
+    void cacheTarget(const std::shared_ptr<FileSystemNode>& node) const noexcept;
+
+    /**
+     * @brief Returns the full path of the link.
+     * @note Placeholder, actual path resolution handled by FileSystemManager.
+     */
+    virtual std::string getFullPath() const override { return ""; }
+
+private:
+    const std::string linkTarget;                      ///< Path the link points to
+    mutable std::weak_ptr<FileSystemNode> resolved;    ///< Final target found by the last resolution
+    mutable std::uint64_t resolvedGeneration{0};       ///< Generation of that resolution, 0 if none
+};
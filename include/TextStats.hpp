@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief Line, word and byte counts of a text, as reported by wc.
+ *
+ * A line is counted per '\n'; a word is a maximal run of bytes that are not
+ * whitespace (' ', '\t', '\n', '\v', '\f', '\r').
+ */
+struct TextStats
+{
+    std::size_t lines{};
+    std::size_t words{};
+    std::size_t bytes{};
+
+    TextStats& operator+=(const TextStats& other) noexcept
+    {
+        lines += other.lines;
+        words += other.words;
+        bytes += other.bytes;
+        return *this;
+    }
+
+    /**
+     * @brief Counts a text, or a continuation of one.
+     *
+     * Classifies 64 bytes per step with SSE2 where available; the tail and
+     * other targets use a scalar loop.
+     *
+     * @param text Bytes to count.
+     * @param afterWord True if the text directly follows a non-whitespace byte,
+     *        so that a word running across the boundary is not counted twice.
+     */
+    static TextStats count(std::string_view text, bool afterWord = false) noexcept;
+
+    /// @brief Whitespace as defined for word counting.
+    static constexpr bool isSpace(char c) noexcept
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+};
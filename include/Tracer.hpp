@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Records execution spans and writes them as a Chrome/Perfetto JSON trace.
+ *
+ * Tracing is opt-in (trace on <file>). While it is off, creating a TraceSpan
+ * costs a single relaxed atomic load.
+ *
+ * Design:
+ * - Every thread records into its own fixed-size ring buffer, so recording takes
+ *   no lock. When a buffer wraps, the oldest spans of that thread are dropped.
+ * - stop() disables recording and writes all buffers to the trace file as
+ *   "complete" (ph: "X") events. Spans still being recorded by other threads
+ *   at that moment may be lost.
+ */
+class Tracer
+{
+public:
+    /// @brief Number of spans kept per thread.
+    static constexpr std::size_t bufferCapacity{std::size_t{1} << 15};
+
+    /// @brief Maximum length of a span detail, longer details are truncated.
+    static constexpr std::size_t maxDetail{31};
+
+    /**
+     * @brief Returns the process-wide tracer.
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief Checks whether spans are currently being recorded.
+     */
+    static bool enabled() noexcept { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Monotonic timestamp used for spans.
+     * @return Nanoseconds since an arbitrary epoch.
+     */
+    static std::uint64_t now() noexcept;
+
+    /**
+     * @brief Starts recording spans.
+     * @param file Path of the trace file written by stop().
+     * @throws InvalidOperationException if tracing is already on.
+     */
+    void start(const std::string& file);
+
+    /**
+     * @brief Stops recording and writes the trace file.
+     * @throws InvalidOperationException if tracing is off.
+     * @throws std::runtime_error if the trace file cannot be opened.
+     */
+    void stop();
+
+    /**
+     * @brief Records a finished span on the calling thread's buffer.
+     *
+     * Nothing is allocated except the thread's buffer on its first span; if
+     * that allocation fails, the thread's spans are dropped.
+     *
+     * @param name Span name, must be a string literal.
+     * @param category Span category, must be a string literal.
+     * @param detail Optional detail, e.g. the command name.
+     * @param startNs Start timestamp from now().
+     * @param endNs End timestamp from now().
+     */
+    void record(const char* name, const char* category, std::string_view detail, std::uint64_t startNs, std::uint64_t endNs) noexcept;
+
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+private:
+    struct Event
+    {
+        const char* name;
+        const char* category;
+        std::uint64_t start;
+        std::uint64_t duration;
+        std::array<char, maxDetail + 1> detail;
+    };
+
+    struct Buffer
+    {
+        std::uint32_t threadId{};
+        std::atomic<std::uint64_t> head{0};  ///< Total spans written, the slot is head % bufferCapacity
+        std::array<Event, bufferCapacity> events;
+    };
+
+    Tracer() = default;
+
+    /// @brief Returns the calling thread's buffer, registering it on first use; nullptr if it cannot be allocated.
+    Buffer* localBuffer() noexcept;
+
+private:
+    static inline std::atomic<bool> active{false};
+
+    std::mutex mutex;                             ///< Guards the buffer list and the output settings
+    std::vector<std::unique_ptr<Buffer>> buffers; ///< All buffers ever created, never freed
+    std::string outputFile;
+    std::uint64_t traceStart{};
+};
+
+/**
+ * @brief RAII span: measures the enclosing scope while tracing is on.
+ *
+ * @code
+ * TraceSpan span{"resolve", "fs"};
+ * @endcode
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(const char* name, const char* category, std::string_view detail = {}) noexcept
+        : name{name}, category{category}, detail{detail}, recording{Tracer::enabled()}
+    {
+        if (recording) start = Tracer::now();
+    }
+
+    ~TraceSpan()
+    {
+        if (recording) Tracer::instance().record(name, category, detail, start, Tracer::now());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    std::string_view detail;
+    bool recording;
+    std::uint64_t start{};
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Directory;
+
+/**
+ * @brief A change to the file system reported to watches.
+ */
+struct WatchEvent
+{
+    enum class Type : std::uint8_t { CREATE, MODIFY, DELETE, MOVE };
+
+    Type type{};
+    bool directory{};    ///< Whether the affected node is a directory
+    std::string path;    ///< Full path of the affected node, the source of a move
+    std::string target;  ///< Full path of the destination of a move, empty otherwise
+
+    /// @brief Upper-case name of the event type, e.g. "CREATE".
+    static const char* typeName(Type type) noexcept;
+};
+
+/**
+ * @brief A subscription to changes below a path.
+ *
+ * A watch reports events for the watched node itself and its direct children;
+ * a recursive watch also reports them for every descendant. Watches follow
+ * paths, not nodes: a watched directory that is moved away is no longer watched.
+ *
+ * Events are delivered through a bounded single-producer single-consumer ring.
+ * The file system thread pushes, one consumer thread polls, and neither side
+ * takes a lock. When the ring is full new events are dropped and counted,
+ * so a slow consumer never stalls the file system.
+ */
+class Watch
+{
+public:
+    /**
+     * @brief Creates a watch, see WatchManager::subscribe.
+     * @param id Identifier of the watch.
+     * @param path Normalized full path being watched.
+     * @param recursive Whether descendants are watched too.
+     * @param capacity Ring capacity, rounded up to a power of two.
+     * @param console Whether the shell prints the events.
+     */
+    Watch(std::uint32_t id, std::string path, bool recursive, std::size_t capacity, bool console);
+
+    std::uint32_t id() const noexcept { return watchId; }
+    const std::string& path() const noexcept { return watchPath; }
+    bool recursive() const noexcept { return isRecursive; }
+    bool console() const noexcept { return isConsole; }
+
+    /// @brief Number of events dropped because the ring was full since the last call.
+    std::uint64_t takeDropped() noexcept { return droppedEvents.exchange(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief Checks whether an event on a path concerns this watch.
+     * @param eventPath Full path of the affected node.
+     */
+    bool matches(std::string_view eventPath) const noexcept;
+
+    /**
+     * @brief Takes the oldest pending event. Must only be called by the consumer thread.
+     * @param event Receives the event.
+     * @return False if no event is pending.
+     */
+    bool poll(WatchEvent& event);
+
+private:
+    friend class WatchManager;
+
+    /// @brief Appends an event, or drops it if the ring is full. Producer side only.
+    void push(const WatchEvent& event);
+
+    const std::uint32_t watchId;
+    const std::string watchPath;
+    const bool isRecursive;
+    const bool isConsole;
+
+    std::unique_ptr<WatchEvent[]> slots;
+    const std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head{0};  ///< Next slot to read, written by the consumer
+    alignas(64) std::atomic<std::size_t> tail{0};  ///< Next slot to write, written by the producer
+    std::atomic<std::uint64_t> droppedEvents{0};
+};
+
+/**
+ * @brief Process-wide registry of watches, fed by the file system.
+ *
+ * Directory and File call the publish functions when nodes are created,
+ * modified or removed; FileSystemManager reports moves. While no watch
+ * exists, every hook costs a single relaxed atomic load and no path is built.
+ *
+ * Design:
+ * - The watch list is guarded by a mutex that is only taken while at least one
+ *   watch exists. Publishing happens on the file system thread, so it is never
+ *   contended by another producer; consumers only touch their own ring.
+ * - A Mute guard silences the hooks on the calling thread, so compound
+ *   operations (a move is a remove and an add) can report a single event.
+ */
+class WatchManager
+{
+public:
+    /// @brief Default ring capacity of a watch.
+    static constexpr std::size_t defaultCapacity{1024};
+
+    /**
+     * @brief Returns the process-wide watch manager.
+     */
+    static WatchManager& instance();
+
+    /**
+     * @brief Checks whether any watch exists and the calling thread is not muted.
+     */
+    static bool enabled() noexcept { return active.load(std::memory_order_relaxed) && muted == 0; }
+
+    /// @brief Silences the hooks on the calling thread for its lifetime.
+    class Mute
+    {
+    public:
+        Mute() noexcept { ++muted; }
+        ~Mute() { --muted; }
+
+        Mute(const Mute&) = delete;
+        Mute& operator=(const Mute&) = delete;
+    };
+
+    /**
+     * @brief Subscribes to changes below a path.
+     * @param path Normalized full path, e.g. "/a/b".
+     * @param recursive Whether descendants are watched too.
+     * @param capacity Ring capacity.
+     * @param console Whether the shell prints the events after each command.
+     * @return The watch; it stays registered until unsubscribed.
+     */
+    std::shared_ptr<Watch> subscribe(std::string path, bool recursive, std::size_t capacity = defaultCapacity, bool console = false);
+
+    /**
+     * @brief Removes a watch. Events already queued can still be polled.
+     * @param id Identifier of the watch.
+     * @return False if no watch has that identifier.
+     */
+    bool unsubscribe(std::uint32_t id);
+
+    /**
+     * @brief Returns all registered watches, oldest first.
+     */
+    std::vector<std::shared_ptr<Watch>> watches() const;
+
+    /**
+     * @brief Reports a created, modified or deleted child.
+     * @param type CREATE, MODIFY or DELETE.
+     * @param parent Directory holding the node.
+     * @param name Name of the node.
+     * @param directory Whether the node is a directory.
+     */
+    void publish(WatchEvent::Type type, const Directory& parent, std::string_view name, bool directory);
+
+    /**
+     * @brief Reports a move.
+     * @param from Full path before the move.
+     * @param to Full path after the move.
+     * @param directory Whether the moved node is a directory.
+     */
+    void publishMove(const std::string& from, const std::string& to, bool directory);
+
+    WatchManager(const WatchManager&) = delete;
+    WatchManager& operator=(const WatchManager&) = delete;
+
+private:
+    WatchManager() = default;
+
+    /// @brief Pushes an event to every matching watch.
+    void deliver(const WatchEvent& event);
+
+private:
+    static inline std::atomic<bool> active{false};
+    static inline thread_local int muted{0};
+
+    mutable std::mutex mutex;  ///< Guards the watch list and the id counter
+    std::vector<std::shared_ptr<Watch>> registered;
+    std::uint32_t nextId{1};
+};
@@ -0,0 +1,146 @@
+#include "../include/AllocationTracker.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+/// Every block carries its requested size in a header, so deletes can be accounted
+/// even when the unsized operator delete is called.
+constexpr std::size_t headerSize{alignof(std::max_align_t)};
+
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> deallocations{0};
+std::atomic<std::size_t> bytesAllocated{0};
+std::atomic<std::size_t> liveBytes{0};
+std::atomic<std::size_t> peakLiveBytes{0};
+
+void countAlloc(std::size_t size) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    std::size_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+
+    std::size_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+}
+
+void countFree(std::size_t size) noexcept
+{
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    liveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void* trackedAlloc(std::size_t size) noexcept
+{
+    void* raw = std::malloc(size + headerSize);
+    if (raw == nullptr) return nullptr;
+
+    *static_cast<std::size_t*>(raw) = size;
+    countAlloc(size);
+
+    return static_cast<char*>(raw) + headerSize;
+}
+
+/// Over-aligned blocks keep the requested size and the block malloc returned
+/// in the two words right below the aligned pointer.
+void* trackedAlignedAlloc(std::size_t size, std::size_t align) noexcept
+{
+    constexpr std::size_t alignedHeader{sizeof(std::size_t) + sizeof(void*)};
+
+    void* raw = std::malloc(size + alignedHeader + align - 1);
+    if (raw == nullptr) return nullptr;
+
+    const std::uintptr_t address{(reinterpret_cast<std::uintptr_t>(raw) + alignedHeader + align - 1) & ~(align - 1)};
+    auto* header = reinterpret_cast<char*>(address) - alignedHeader;
+    std::memcpy(header, &size, sizeof(size));
+    std::memcpy(header + sizeof(size), &raw, sizeof(raw));
+    countAlloc(size);
+
+    return reinterpret_cast<void*>(address);
+}
+
+void* allocOrThrow(std::size_t size, std::size_t align = 0)
+{
+    if (size == 0) size = 1;
+
+    while (true) {
+        if (void* p = align == 0 ? trackedAlloc(size) : trackedAlignedAlloc(size, align)) return p;
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void trackedFree(void* p) noexcept
+{
+    if (p == nullptr) return;
+
+    void* raw = static_cast<char*>(p) - headerSize;
+    countFree(*static_cast<std::size_t*>(raw));
+
+    std::free(raw);
+}
+
+void trackedAlignedFree(void* p) noexcept
+{
+    if (p == nullptr) return;
+
+    const char* header = static_cast<char*>(p) - sizeof(std::size_t) - sizeof(void*);
+    std::size_t size{};
+    void* raw{};
+    std::memcpy(&size, header, sizeof(size));
+    std::memcpy(&raw, header + sizeof(size), sizeof(raw));
+    countFree(size);
+
+    std::free(raw);
+}
+
+} // namespace
+
+AllocationTracker::Snapshot AllocationTracker::snapshot() noexcept
+{
+    return {
+        allocations.load(std::memory_order_relaxed),
+        deallocations.load(std::memory_order_relaxed),
+        bytesAllocated.load(std::memory_order_relaxed),
+        liveBytes.load(std::memory_order_relaxed),
+        peakLiveBytes.load(std::memory_order_relaxed)
+    };
+}
+
+void AllocationTracker::resetPeak() noexcept
+{
+    peakLiveBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// ---------------- Global operator new/delete hooks ----------------
+void* operator new(std::size_t size) { return allocOrThrow(size); }
+void* operator new[](std::size_t size) { return allocOrThrow(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size == 0 ? 1 : size); }
+
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+
+void* operator new(std::size_t size, std::align_val_t align) { return allocOrThrow(size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align) { return allocOrThrow(size, static_cast<std::size_t>(align)); }
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return trackedAlignedAlloc(size == 0 ? 1 : size, static_cast<std::size_t>(align)); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return trackedAlignedAlloc(size == 0 ? 1 : size, static_cast<std::size_t>(align)); }
+
+void operator delete(void* p, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { trackedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { trackedAlignedFree(p); }
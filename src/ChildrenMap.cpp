@@ -0,0 +1,188 @@
+#include "../include/ChildrenMap.hpp"
+
+#include <algorithm>
+#include <bit>
+
+ChildrenMap::iterator ChildrenMap::find(std::string_view name) const
+{
+    if (!large) {
+        for (std::size_t i{}; i < smallSize; ++i) {
+            if (inline_[i]->getName() == name) return iterator{&inline_[i]};
+        }
+
+        return end();
+    }
+
+    if (large->index.empty()) return iterator{large->entries.find(name)};
+    return iterator{Storage::const_iterator{indexFind(name)}};
+}
+
+std::pair<ChildrenMap::iterator, bool> ChildrenMap::emplace(Node node)
+{
+    const std::string& name{node->getName()};
+    if (!large && smallSize == smallCapacity && !contains(name)) promote();
+
+    if (large) {
+        auto [it, inserted] = large->entries.try_emplace(name, std::move(node));
+        if (inserted) {
+            if (!large->index.empty()) indexInsert(it);
+            else updateIndex();
+        }
+
+        return {iterator{Storage::const_iterator{it}}, inserted};
+    }
+
+    auto pos = static_cast<std::size_t>(lowerBound(name).small - inline_.data());
+    if (pos < smallSize && inline_[pos]->getName() == name) return {iterator{&inline_[pos]}, false};
+
+    std::move_backward(inline_.begin() + pos, inline_.begin() + smallSize, inline_.begin() + smallSize + 1);
+    inline_[pos] = std::move(node);
+    ++smallSize;
+
+    return {iterator{&inline_[pos]}, true};
+}
+
+void ChildrenMap::erase(iterator it)
+{
+    if (!large) {
+        auto pos = static_cast<std::size_t>(it.small - inline_.data());
+        std::move(inline_.begin() + pos + 1, inline_.begin() + smallSize, inline_.begin() + pos);
+        inline_[--smallSize].reset();
+        return;
+    }
+
+    // The key views the node's name, so the entry goes before the node may be freed.
+    auto entry = large->entries.erase(it.large, it.large);  // const_iterator -> iterator
+    if (!large->index.empty()) indexErase(entry);
+    large->entries.erase(entry);
+
+    if (large->entries.size() <= smallCapacity / 2) demote();
+    else updateIndex();
+}
+
+ChildrenMap::iterator ChildrenMap::lowerBound(std::string_view name) const
+{
+    if (large) return iterator{large->entries.lower_bound(name)};
+
+    auto it = std::lower_bound(inline_.begin(), inline_.begin() + smallSize, name,
+                               [] (const Node& node, std::string_view n) { return node->getName() < n; });
+    return iterator{inline_.data() + (it - inline_.begin())};
+}
+
+ChildrenMap::iterator ChildrenMap::upperBound(std::string_view name) const
+{
+    if (large) return iterator{large->entries.upper_bound(name)};
+
+    auto it = std::upper_bound(inline_.begin(), inline_.begin() + smallSize, name,
+                               [] (std::string_view n, const Node& node) { return n < node->getName(); });
+    return iterator{inline_.data() + (it - inline_.begin())};
+}
+
+std::pair<ChildrenMap::iterator, ChildrenMap::iterator> ChildrenMap::prefixRange(std::string_view prefix) const
+{
+    auto first = lowerBound(prefix);
+
+    // The range ends at the smallest string greater than every name with this prefix:
+    // the prefix with its last byte incremented, dropping trailing 0xFF bytes.
+    std::string limit{prefix};
+    while (!limit.empty() && static_cast<unsigned char>(limit.back()) == 0xFF) limit.pop_back();
+    if (limit.empty()) return {first, end()};
+
+    limit.back() = static_cast<char>(static_cast<unsigned char>(limit.back()) + 1);
+    return {first, lowerBound(limit)};
+}
+
+void ChildrenMap::promote()
+{
+    large = std::make_unique<Large>();
+    for (std::size_t i{}; i < smallSize; ++i) {
+        std::string_view name{inline_[i]->getName()};
+        large->entries.emplace_hint(large->entries.end(), name, std::move(inline_[i]));
+    }
+
+    smallSize = 0;
+}
+
+void ChildrenMap::demote()
+{
+    smallSize = 0;
+    for (auto& [_, node] : large->entries) {
+        inline_[smallSize++] = std::move(node);
+    }
+
+    large.reset();
+}
+
+void ChildrenMap::updateIndex()
+{
+    auto& index = large->index;
+    const std::size_t size{large->entries.size()};
+
+    if (index.empty() && size >= indexThreshold) {
+        indexRebuild(std::bit_ceil(size * 2));
+    }
+    else if (!index.empty() && size < indexThreshold / 2) {
+        index = {};
+    }
+}
+
+ChildrenMap::Storage::iterator ChildrenMap::indexFind(std::string_view name) const
+{
+    const auto& index = large->index;
+    const std::size_t mask{index.size() - 1};
+
+    for (std::size_t i{std::hash<std::string_view>{}(name) & mask}; index[i] != large->entries.end(); i = (i + 1) & mask) {
+        if (index[i]->first == name) return index[i];
+    }
+
+    return large->entries.end();
+}
+
+void ChildrenMap::indexInsert(Storage::iterator it)
+{
+    auto& index = large->index;
+    if (large->entries.size() * 2 > index.size()) {
+        indexRebuild(index.size() * 2);  // the entry is already in the map, so the rebuild adds it
+        return;
+    }
+
+    const std::size_t mask{index.size() - 1};
+    std::size_t i{std::hash<std::string_view>{}(it->first) & mask};
+    while (index[i] != large->entries.end()) i = (i + 1) & mask;
+    index[i] = it;
+}
+
+void ChildrenMap::indexErase(Storage::iterator it)
+{
+    auto& index = large->index;
+    const auto free = large->entries.end();
+    const std::size_t mask{index.size() - 1};
+
+    std::size_t i{std::hash<std::string_view>{}(it->first) & mask};
+    while (index[i] != it) i = (i + 1) & mask;
+
+    // Backward-shift deletion: pull later entries of the probe chain into the hole.
+    for (std::size_t j{(i + 1) & mask}; index[j] != free; j = (j + 1) & mask) {
+        std::size_t home{std::hash<std::string_view>{}(index[j]->first) & mask};
+        bool movable = i <= j ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            index[i] = index[j];
+            i = j;
+        }
+    }
+
+    index[i] = free;
+}
+
+void ChildrenMap::indexRebuild(std::size_t slots)
+{
+    auto& index = large->index;
+    index.assign(slots, large->entries.end());
+
+    const std::size_t mask{slots - 1};
+    for (auto it = large->entries.begin(); it != large->entries.end(); ++it) {
+        std::size_t i{std::hash<std::string_view>{}(it->first) & mask};
+        while (index[i] != large->entries.end()) i = (i + 1) & mask;
+        index[i] = it;
+    }
+}
@@ -1,15 +1,87 @@
 #include "../include/CommandParser.hpp"
+#include "../include/AllocationTracker.hpp"
+#include "../include/MetricsRegistry.hpp"
+#include "../include/Tracer.hpp"
+#include "../include/SessionRecorder.hpp"
+#include "../include/WatchManager.hpp"
+#include "../include/History.hpp"
+#include "../utility/Utils.hpp"
 
-std::vector<std::string> CommandParser::parse(const std::string& input) const
+#include <cctype>
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <limits>
+
+namespace {
+
+/// @brief Position of the quote closing the one at `open`, skipping escaped ones inside double quotes; npos if none.
+std::size_t closingQuote(const std::string& input, std::size_t open) noexcept
 {
-    std::stringstream ss{input};
-    std::string s;
-    std::vector<std::string> res;
+    const char quote{input[open]};
+    for (std::size_t i{open + 1}; i < input.size(); ++i) {
+        if (input[i] == quote) return i;
+        if (quote == '"' && input[i] == '\\' && i + 1 < input.size() && (input[i + 1] == '"' || input[i + 1] == '\\')) ++i;
+    }
+    return std::string::npos;
+}
+
+} // namespace
+
+std::vector<CommandParser::Word> CommandParser::parse(const std::string& input) const
+{
+    std::vector<Word> res;
+    std::string literal;   // the word with quotes and escapes removed
+    std::string pattern;   // the word as a pattern, quoted wildcards escaped
+    bool inWord{false};
+    bool hasWildcard{false};
+
+    auto addLiteral = [&] (char c) {
+        literal += c;
+        if (c == '*' || c == '?' || c == '[' || c == '\\') pattern += '\\';
+        pattern += c;
+    };
+
+    auto endWord = [&] {
+        if (inWord) res.push_back({hasWildcard ? pattern : literal, hasWildcard, hasWildcard ? literal : std::string{}});
+        literal.clear();
+        pattern.clear();
+        inWord = hasWildcard = false;
+    };
+
+    for (std::size_t i{}; i < input.size(); ++i) {
+        const char c{input[i]};
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            endWord();
+            continue;
+        }
+
+        inWord = true;
+        if (c == '\\' && i + 1 < input.size()) {
+            addLiteral(input[++i]);
+        }
+        else if ((c == '\'' || c == '"') && input.find(c, i + 1) != std::string::npos) {
+            // A quote without a closing partner is taken literally, e.g. "it's";
+            // one whose partners are all escaped is left open.
+            const std::size_t close{closingQuote(input, i)};
+            if (close == std::string::npos) throw InvalidOperationException("Unterminated quote: " + input.substr(i));
 
-    while (ss >> s) {
-        res.push_back(s);
+            for (++i; i < close; ++i) {
+                if (c == '"' && input[i] == '\\' && (input[i + 1] == '"' || input[i + 1] == '\\')) ++i;
+                addLiteral(input[i]);
+            }
+        }
+        else if (c == '*' || c == '?' || c == '[') {
+            literal += c;
+            pattern += c;
+            hasWildcard = true;
+        }
+        else {
+            addLiteral(c);
+        }
     }
 
+    endWord();
     return res;
 }
 
@@ -18,6 +90,17 @@ std::unique_ptr<Command> CommandParser::createCommand(const std::string& name) c
     return registry.contains(name) ? registry.at(name)() : nullptr;
 }
 
+std::vector<std::string> CommandParser::commandNames(std::string_view prefix) const
+{
+    std::vector<std::string> res;
+    for (const auto& [name, factory] : registry) {
+        if (name.starts_with(prefix)) res.push_back(name);
+    }
+
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
 CommandParser::CommandParser()
 {
     registry["pwd"]     = [] { return std::make_unique<PWDCommand>(); };
@@ -33,6 +116,31 @@ CommandParser::CommandParser()
     registry["mv"]      = [] { return std::make_unique<MVCommand>(); };
     registry["grep"]    = [] { return std::make_unique<GREPCommand>(); };
     registry["toJson"]  = [] { return std::make_unique<ToJsonCommand>(); };
+    registry["time"]    = [this] { return std::make_unique<TIMECommand>(*this); };
+    registry["stats"]   = [] { return std::make_unique<STATSCommand>(); };
+    registry["du"]      = [] { return std::make_unique<DUCommand>(); };
+    registry["df"]      = [] { return std::make_unique<DFCommand>(); };
+    registry["trace"]   = [] { return std::make_unique<TRACECommand>(); };
+    registry["record"]  = [] { return std::make_unique<RECORDCommand>(); };
+    registry["stat"]    = [] { return std::make_unique<STATCommand>(); };
+    registry["tree"]    = [] { return std::make_unique<TREECommand>(); };
+    registry["head"]    = [] { return std::make_unique<HEADCommand>(); };
+    registry["tail"]    = [] { return std::make_unique<TAILCommand>(); };
+    registry["read"]    = [] { return std::make_unique<READCommand>(); };
+    registry["write"]   = [] { return std::make_unique<WRITECommand>(); };
+    registry["watch"]   = [] { return std::make_unique<WATCHCommand>(); };
+    registry["unwatch"] = [] { return std::make_unique<UNWATCHCommand>(); };
+    registry["export"]  = [] { return std::make_unique<EXPORTCommand>(); };
+    registry["wc"]      = [] { return std::make_unique<WCCommand>(); };
+    registry["sum"]     = [] { return std::make_unique<SUMCommand>(); };
+    registry["hash"]    = [] { return std::make_unique<HASHCommand>(); };
+    registry["diff-tree"] = [] { return std::make_unique<DIFFTREECommand>(); };
+    registry["diff"]    = [] { return std::make_unique<DIFFCommand>(); };
+    registry["ln"]      = [] { return std::make_unique<LNCommand>(); };
+    registry["sort"]    = [] { return std::make_unique<SORTCommand>(); };
+    registry["uniq"]    = [] { return std::make_unique<UNIQCommand>(); };
+    registry["sed"]     = [] { return std::make_unique<SEDCommand>(); };
+    registry["history"] = [] { return std::make_unique<HISTORYCommand>(); };
 }
 
 // ---------------- PWDCommand ----------------
@@ -56,14 +164,60 @@ void MKDIRCommand::execute(FileSystemManager& fsManager, const std::vector<std::
 // ---------------- LSCommand ----------------
 void LSCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
 {
-    std::string path = args.empty() ? "" : args[0];
-    auto vec = fsManager.ls(path);
+    bool longFormat{false};
+    bool recursive{false};
+    std::size_t limit{std::numeric_limits<std::size_t>::max()};
+    std::string after;
+    std::string path;
+
+    for (std::size_t i{}; i < args.size(); ++i) {
+        if (args[i] == "-l") longFormat = true;
+        else if (args[i] == "-R") recursive = true;
+        else if (args[i] == "--limit" && i + 1 < args.size()) {
+            // A page of no entries would never make progress.
+            limit = utility::parseCount(args[++i]);
+            if (limit == 0) throw InvalidOptionException(args[i]);
+        }
+        else if (args[i] == "--after" && i + 1 < args.size()) after = args[++i];
+        else if (path.empty()) path = args[i];
+        else throw InvalidOptionException(args[i]);
+    }
 
-    for (const std::string& s : vec) {
-        std::cout << s << " ";
+    if (recursive && (limit != std::numeric_limits<std::size_t>::max() || !after.empty())) {
+        throw InvalidOperationException("ls -R cannot be paged");
     }
 
-    std::cout << std::endl;
+    // Streams the listing through a bounded buffer instead of collecting it.
+    utility::BufferedWriter out{std::cout};
+    auto printEntry = [&] (const std::string& name, const FileSystemNode& node) {
+        if (longFormat) {
+            std::ostringstream ss;
+            ss << (node.isDirectory() ? 'd' : node.isSymlink() ? 'l' : '-') << " " << std::setw(10) << (node.isSymlink() ? node.getSize() : node.getUsage().bytes) << " "
+               << utility::formatTime(node.getMetadata().modified) << " " << name;
+            if (node.isSymlink()) ss << " -> " << nodeCast<Symlink>(node).target();
+            ss << "\n";
+            out << ss.str();
+        }
+        else {
+            out << name << ' ';
+        }
+    };
+
+    TraceSpan span{"output", "shell"};
+    if (recursive) {
+        bool first{true};
+        fsManager.walkDirectories(path, [&] (const std::string& dirPath, const Directory& dir) {
+            out << (first ? "" : "\n") << dirPath << ":\n";
+            dir.forEachChild({}, std::numeric_limits<std::size_t>::max(), printEntry);
+            if (!longFormat) out << '\n';
+            first = false;
+        });
+        return;
+    }
+
+    auto next = fsManager.lsPage(path, after, limit, printEntry);
+    if (!longFormat) out << '\n';
+    if (next) out << "-- more, continue with --after " << *next << '\n';
 }
 
 // ---------------- RMDIRCommand ----------------
@@ -83,7 +237,9 @@ void RMDIRCommand::execute(FileSystemManager& fsManager, const std::vector<std::
 // ---------------- RMDCommand ----------------
 void RMDCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
 {
-    fsManager.rm(args.back());
+    for (const std::string& name : args) {
+        fsManager.rm(name);
+    }
 }
 
 // ---------------- TOUCHCommand ----------------
@@ -121,6 +277,7 @@ void ECHOCommand::execute(FileSystemManager& fsManager, const std::vector<std::s
             if (i > 0) ss << " ";
             ss << args[i];
         }
+        TraceSpan span{"output", "shell"};
         std::cout << ss.str() << std::endl;
     }
 }
@@ -128,7 +285,12 @@ void ECHOCommand::execute(FileSystemManager& fsManager, const std::vector<std::s
 // ---------------- CATCommand ----------------
 void CATCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
 {
-    std::cout << fsManager.readFile(args.front()) << std::endl;
+    for (const std::string& name : args) {
+        std::string content{fsManager.readFile(name)};
+
+        TraceSpan span{"output", "shell"};
+        std::cout << content << std::endl;
+    }
 }
 
 // ---------------- CPCommand ----------------
@@ -188,6 +350,7 @@ void GREPCommand::execute(FileSystemManager& fsManager, const std::vector<std::s
         res = fsManager.grep(args[0], args[1]);
     }
 
+    TraceSpan span{"output", "shell"};
     if (res.has_value()) {
         for (const auto& s : res.value()) {
             std::cout << s << "\n";
@@ -206,6 +369,8 @@ void ToJsonCommand::execute(FileSystemManager& fsManager, const std::vector<std:
 
     FileSystemManager::json j = fsManager.convertToJson(path);
 
+    TraceSpan span{"output", "shell"};
+
     std::ofstream out(outputFile, std::ios::trunc);
     if (!out.is_open()) {
         throw std::runtime_error("Cannot open output file: " + outputFile);
@@ -214,3 +379,539 @@ void ToJsonCommand::execute(FileSystemManager& fsManager, const std::vector<std:
     out << j.dump(4) << "\n";
     out.close();
 }
+
+// ---------------- TIMECommand ----------------
+void TIMECommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    auto command = parser.createCommand(args.front());
+    if (command == nullptr) throw InvalidOperationException("Unknown command: " + args.front());
+
+    std::vector<std::string> commandArgs{args.begin() + 1, args.end()};
+    if (!command->validate(commandArgs)) throw InvalidOperationException("Invalid arguments for " + args.front());
+
+    AllocationTracker::resetPeak();
+    const auto before = AllocationTracker::snapshot();
+    const std::clock_t cpuStart = std::clock();
+    const auto wallStart = std::chrono::steady_clock::now();
+
+    // Reports even when the wrapped command throws, the slow path is often the failing one.
+    auto report = [&] {
+        const auto wallEnd = std::chrono::steady_clock::now();
+        const std::clock_t cpuEnd = std::clock();
+        const auto after = AllocationTracker::snapshot();
+
+        const double wall = std::chrono::duration<double>(wallEnd - wallStart).count();
+        const double cpu = static_cast<double>(cpuEnd - cpuStart) / CLOCKS_PER_SEC;
+
+        std::ostringstream ss;
+        ss << std::fixed;
+        ss.precision(6);
+        ss << "real   " << wall << "s\n"
+           << "cpu    " << cpu << "s\n"
+           << "allocs " << after.allocations - before.allocations
+           << " (" << after.bytesAllocated - before.bytesAllocated << " bytes), "
+           << "frees " << after.deallocations - before.deallocations << "\n"
+           << "peak   +" << after.peakLiveBytes - before.liveBytes << " bytes\n";
+        std::cout << ss.str();
+    };
+
+    try {
+        command->execute(fsManager, commandArgs);
+    }
+    catch (...) {
+        report();
+        throw;
+    }
+
+    report();
+}
+
+// ---------------- STATSCommand ----------------
+void STATSCommand::execute([[maybe_unused]] FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    auto& metrics = MetricsRegistry::instance();
+
+    if (!args.empty()) {
+        const std::string& outputFile = args[1];
+        std::ofstream out(outputFile, std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("Cannot open output file: " + outputFile);
+        }
+
+        metrics.writePrometheus(out);
+        return;
+    }
+
+    const auto stats = metrics.snapshot();
+    std::ostringstream ss;
+    ss << std::left << std::setw(10) << "command" << std::right
+       << std::setw(8) << "count" << std::setw(8) << "errors"
+       << std::setw(10) << "p50" << std::setw(10) << "p99"
+       << std::setw(10) << "p999" << std::setw(10) << "max" << "\n";
+
+    for (const auto& s : stats) {
+        ss << std::left << std::setw(10) << s.name << std::right
+           << std::setw(8) << s.count << std::setw(8) << s.errorCount()
+           << std::setw(10) << utility::formatDuration(s.latency.quantile(0.5))
+           << std::setw(10) << utility::formatDuration(s.latency.quantile(0.99))
+           << std::setw(10) << utility::formatDuration(s.latency.quantile(0.999))
+           << std::setw(10) << utility::formatDuration(s.latency.max()) << "\n";
+    }
+
+    for (const auto& s : stats) {
+        for (const auto& [kind, n] : s.errors) {
+            ss << s.name << ": " << n << " x " << kind << "\n";
+        }
+    }
+
+    std::cout << ss.str();
+}
+
+// ---------------- DUCommand ----------------
+void DUCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    bool summarize{false};
+    std::string path;
+
+    for (const std::string& arg : args) {
+        if (arg == "-s") summarize = true;
+        else if (path.empty()) path = arg;
+        else throw InvalidOptionException(arg);
+    }
+
+    std::ostringstream ss;
+    for (const auto& [dirPath, usage] : fsManager.du(path, summarize)) {
+        ss << usage.bytes << "\t" << dirPath << "\n";
+    }
+
+    TraceSpan span{"output", "shell"};
+    std::cout << ss.str();
+}
+
+// ---------------- DFCommand ----------------
+void DFCommand::execute(FileSystemManager& fsManager, [[maybe_unused]] const std::vector<std::string>& args)
+{
+    const auto report = fsManager.df();
+
+    std::ostringstream ss;
+    ss << "content   " << report.usage.bytes << " bytes\n"
+       << "nodes     " << report.usage.files + report.usage.directories
+       << " (" << report.usage.files << " files, " << report.usage.directories << " directories)\n"
+       << "node      " << report.nodeOverhead << " bytes (estimated)\n"
+       << "metadata  " << report.metadataOverhead << " bytes (estimated)\n"
+       << "total     " << report.total() << " bytes\n";
+
+    std::cout << ss.str();
+}
+
+// ---------------- TRACECommand ----------------
+void TRACECommand::execute([[maybe_unused]] FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    if (args[0] == "on") Tracer::instance().start(args[1]);
+    else Tracer::instance().stop();
+}
+
+// ---------------- RECORDCommand ----------------
+void RECORDCommand::execute([[maybe_unused]] FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    if (args[0] == "off") SessionRecorder::instance().stop();
+    else SessionRecorder::instance().start(args[0]);
+}
+
+// ---------------- STATCommand ----------------
+void STATCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    const auto info = fsManager.stat(args.front());
+
+    std::ostringstream ss;
+    ss << "  File: " << info.name;
+    if (!info.target.empty()) ss << " -> " << info.target;
+    ss << "\n"
+       << "  Type: " << (info.kind == FileSystemNode::Kind::FILE ? "regular file" : FileSystemNode::kindName(info.kind)) << "\n"
+       << "  Size: " << info.size << " bytes\n"
+       << " Links: " << info.links << "\n"
+       << "Create: " << utility::formatTime(info.metadata.created) << "\n"
+       << "Modify: " << utility::formatTime(info.metadata.modified) << "\n";
+
+    std::cout << ss.str();
+}
+
+// ---------------- TREECommand ----------------
+void TREECommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    std::size_t maxDepth{std::numeric_limits<std::size_t>::max()};
+    std::string path;
+
+    for (std::size_t i{}; i < args.size(); ++i) {
+        if (args[i] == "-L" && i + 1 < args.size()) maxDepth = utility::parseCount(args[++i]);
+        else if (path.empty()) path = args[i];
+        else throw InvalidOptionException(args[i]);
+    }
+
+    if (maxDepth == 0) throw InvalidOptionException("-L 0");
+
+    std::size_t directories{}, files{};
+    std::vector<bool> lastAtDepth;  // whether the open ancestor at each depth was the last of its siblings
+
+    utility::BufferedWriter out{std::cout};
+    out << (path.empty() ? "." : path) << '\n';
+
+    TraceSpan span{"output", "shell"};
+    fsManager.walk(path, maxDepth, [&] (const std::string& name, const FileSystemNode& node, std::size_t depth, bool last) {
+        lastAtDepth.resize(depth);
+        lastAtDepth[depth - 1] = last;
+
+        for (std::size_t d{}; d + 1 < depth; ++d) out << (lastAtDepth[d] ? "    " : "\u2502   ");
+        out << (last ? "\u2514\u2500\u2500 " : "\u251c\u2500\u2500 ") << name;
+        if (node.isSymlink()) out << " -> " << nodeCast<Symlink>(node).target();
+        out << '\n';
+
+        if (node.isDirectory()) ++directories;
+        else ++files;
+    });
+
+    out << '\n' << directories << (directories == 1 ? " directory, " : " directories, ")
+        << files << (files == 1 ? " file\n" : " files\n");
+}
+
+namespace {
+
+/// @brief Parses `[-n count] <file>` for head and tail.
+std::pair<std::string, std::size_t> parseLineRange(const std::vector<std::string>& args)
+{
+    std::size_t lines{10};
+    std::string path;
+
+    for (std::size_t i{}; i < args.size(); ++i) {
+        if (args[i] == "-n" && i + 1 < args.size()) lines = utility::parseCount(args[++i]);
+        else if (path.empty()) path = args[i];
+        else throw InvalidOptionException(args[i]);
+    }
+
+    if (path.empty()) throw InvalidOperationException("No file specified");
+    return {path, lines};
+}
+
+/// @brief Writes a view of a file straight to stdout, ending it with a newline if it lacks one.
+void printView(std::string_view text)
+{
+    TraceSpan span{"output", "shell"};
+    std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+    if (!text.empty() && text.back() != '\n') std::cout << '\n';
+    std::cout.flush();
+}
+
+} // namespace
+
+// ---------------- HEADCommand ----------------
+void HEADCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    const auto [path, lines] = parseLineRange(args);
+    printView(fsManager.head(path, lines));
+}
+
+// ---------------- TAILCommand ----------------
+void TAILCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    const auto [path, lines] = parseLineRange(args);
+    printView(fsManager.tail(path, lines));
+}
+
+// ---------------- READCommand ----------------
+void READCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    printView(fsManager.readRange(args[0], utility::parseCount(args[1]), utility::parseCount(args[2])));
+}
+
+// ---------------- WRITECommand ----------------
+void WRITECommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    std::optional<std::size_t> offset;
+    std::size_t i{};
+    if (args[0] == "--at") {
+        if (args.size() < 4) throw InvalidOperationException("write --at needs an offset, a file and text");
+        offset = utility::parseCount(args[1]);
+        i = 2;
+    }
+
+    const std::string& path{args[i++]};
+    std::string text;
+    for (std::size_t first{i}; i < args.size(); ++i) {
+        if (i > first) text += ' ';
+        text += args[i];
+    }
+
+    if (offset) fsManager.writeAt(path, *offset, text);
+    else fsManager.appendTo(path, text);
+}
+
+// ---------------- WATCHCommand ----------------
+void WATCHCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    if (args.empty()) {
+        std::ostringstream ss;
+        for (const auto& watch : WatchManager::instance().watches()) {
+            if (!watch->console()) continue;
+            ss << watch->id() << "\t" << (watch->recursive() ? "-r " : "") << watch->path() << "\n";
+        }
+        std::cout << ss.str();
+        return;
+    }
+
+    bool recursive{false};
+    std::optional<std::string> path;
+    for (const std::string& arg : args) {
+        if (arg == "-r") recursive = true;
+        else if (!path) path = arg;
+        else throw InvalidOptionException(arg);
+    }
+
+    auto watch = WatchManager::instance().subscribe(fsManager.realPath(path.value_or(".")), recursive, WatchManager::defaultCapacity, true);
+    std::cout << "Watching " << watch->path() << " (id " << watch->id() << ")\n";
+}
+
+// ---------------- UNWATCHCommand ----------------
+void UNWATCHCommand::execute([[maybe_unused]] FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    const std::size_t id{utility::parseCount(args.front())};
+    if (id > std::numeric_limits<std::uint32_t>::max() || !WatchManager::instance().unsubscribe(static_cast<std::uint32_t>(id))) {
+        throw InvalidOperationException("No watch with id " + args.front());
+    }
+}
+
+// ---------------- EXPORTCommand ----------------
+void EXPORTCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    const auto report = fsManager.exportTree(args[0], args[1]);
+
+    std::ostringstream ss;
+    ss << "Exported " << report.files << (report.files == 1 ? " file, " : " files, ")
+       << report.directories << (report.directories == 1 ? " directory, " : " directories, ");
+    if (report.symlinks > 0) ss << report.symlinks << (report.symlinks == 1 ? " symbolic link, " : " symbolic links, ");
+    ss << report.bytes << " bytes";
+    if (report.skippedSymlinks > 0) {
+        ss << " (" << report.skippedSymlinks << (report.skippedSymlinks == 1 ? " symbolic link" : " symbolic links") << " pointing outside skipped)";
+    }
+    ss << "\n";
+    std::cout << ss.str();
+}
+
+// ---------------- WCCommand ----------------
+void WCCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    bool lines{false}, words{false}, bytes{false};
+    std::vector<std::string> files;
+    for (const std::string& arg : args) {
+        if (arg == "-l") lines = true;
+        else if (arg == "-w") words = true;
+        else if (arg == "-c") bytes = true;
+        else files.push_back(arg);
+    }
+
+    if (files.empty()) throw InvalidOperationException("No file specified");
+    if (!lines && !words && !bytes) lines = words = bytes = true;
+
+    std::ostringstream ss;
+    auto print = [&] (const TextStats& stats, const std::string& name) {
+        if (lines) ss << std::setw(8) << stats.lines;
+        if (words) ss << std::setw(8) << stats.words;
+        if (bytes) ss << std::setw(8) << stats.bytes;
+        ss << " " << name << "\n";
+    };
+
+    TextStats total;
+    for (const std::string& file : files) {
+        const TextStats stats{fsManager.wc(file)};
+        print(stats, file);
+        total += stats;
+    }
+    if (files.size() > 1) print(total, "total");
+
+    std::cout << ss.str();
+}
+
+// ---------------- SUMCommand ----------------
+void SUMCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    std::ostringstream ss;
+    for (const std::string& file : args) {
+        ss << fsManager.hash(file, HashAlgorithm::XXH64) << "  " << file << "\n";
+    }
+    std::cout << ss.str();
+}
+
+// ---------------- HASHCommand ----------------
+void HASHCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    bool recursive{false};
+    HashAlgorithm algorithm{HashAlgorithm::XXH64};
+    std::string path;
+
+    for (const std::string& arg : args) {
+        if (arg == "-r") recursive = true;
+        else if (arg == "--sha256") algorithm = HashAlgorithm::SHA256;
+        else if (path.empty()) path = arg;
+        else throw InvalidOptionException(arg);
+    }
+
+    // Without a path, -r hashes the current directory.
+    if (path.empty() && !recursive) throw InvalidOperationException("No file specified");
+
+    utility::BufferedWriter out{std::cout};
+    if (!recursive) {
+        out << fsManager.hash(path, algorithm) << "  " << path << '\n';
+        return;
+    }
+
+    fsManager.hashTree(path, algorithm, [&] (const std::string& filePath, const std::string& digest) {
+        out << digest << "  " << filePath << '\n';
+    });
+}
+
+// ---------------- DIFFTREECommand ----------------
+void DIFFTREECommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    utility::BufferedWriter out{std::cout};
+    fsManager.diffTree(args[0], args[1], [&] (const FileSystemManager::TreeChange& change) {
+        using Type = FileSystemManager::TreeChange::Type;
+        switch (change.type) {
+            case Type::ADDED:        out << 'A'; break;
+            case Type::DELETED:      out << 'D'; break;
+            case Type::MODIFIED:     out << 'M'; break;
+            case Type::TYPE_CHANGED: out << 'T'; break;
+        }
+
+        out << '\t' << (change.path.empty() ? "." : change.path);
+        if (change.directory) out << '/';
+        out << '\n';
+    });
+}
+
+// ---------------- DIFFCommand ----------------
+void DIFFCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    std::size_t context{3};
+    std::vector<std::string> files;
+    for (std::size_t i{}; i < args.size(); ++i) {
+        if (args[i] == "-u") continue;
+        if (args[i] == "-U" && i + 1 < args.size()) context = utility::parseCount(args[++i]);
+        else if (files.size() < 2) files.push_back(args[i]);
+        else throw InvalidOptionException(args[i]);
+    }
+
+    if (files.size() != 2) throw InvalidOperationException("diff needs two files");
+
+    utility::BufferedWriter out{std::cout};
+    fsManager.diff(files[0], files[1], context, [&] (std::string_view text) { out << text; });
+}
+
+// ---------------- LNCommand ----------------
+void LNCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    bool symbolic{false};
+    std::vector<std::string> paths;
+    for (const std::string& arg : args) {
+        if (arg == "-s") symbolic = true;
+        else if (paths.size() < 2) paths.push_back(arg);
+        else throw InvalidOptionException(arg);
+    }
+
+    if (paths.empty()) throw InvalidOperationException("ln needs a target");
+    if (paths.size() == 1) paths.push_back(".");  // links into the current directory under the target's name
+
+    if (symbolic) fsManager.symlink(paths[0], paths[1]);
+    else fsManager.link(paths[0], paths[1]);
+}
+
+// ---------------- SORTCommand ----------------
+void SORTCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    SortOptions options;
+    std::string output;
+    std::string path;
+
+    for (std::size_t i{}; i < args.size(); ++i) {
+        if (args[i] == "-r") options.reverse = true;
+        else if (args[i] == "-n") options.numeric = true;
+        else if (args[i] == "-u") options.unique = true;
+        else if (args[i] == "-o" && i + 1 < args.size()) output = args[++i];
+        else if (path.empty()) path = args[i];
+        else throw InvalidOptionException(args[i]);
+    }
+
+    if (path.empty()) throw InvalidOperationException("No file specified");
+
+    if (!output.empty()) {
+        fsManager.sortToFile(path, options, output);
+        return;
+    }
+
+    utility::BufferedWriter out{std::cout};
+    for (std::string_view line : fsManager.sort(path, options)) out << line << '\n';
+}
+
+// ---------------- UNIQCommand ----------------
+void UNIQCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    bool counts{false};
+    std::string path;
+
+    for (const std::string& arg : args) {
+        if (arg == "-c") counts = true;
+        else if (path.empty()) path = arg;
+        else throw InvalidOptionException(arg);
+    }
+
+    if (path.empty()) throw InvalidOperationException("No file specified");
+
+    utility::BufferedWriter out{std::cout};
+    fsManager.uniq(path, [&] (std::string_view line, std::size_t count) {
+        if (counts) {
+            const std::string number{std::to_string(count)};
+            if (number.size() < 7) out << std::string(7 - number.size(), ' ');
+            out << number << ' ';
+        }
+        out << line << '\n';
+    });
+}
+
+// ---------------- SEDCommand ----------------
+void SEDCommand::execute(FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    bool inPlace{false};
+    bool extended{false};
+    std::vector<std::string> operands;
+    for (const std::string& arg : args) {
+        if (arg == "-i") inPlace = true;
+        else if (arg == "-E") extended = true;
+        else if (operands.size() < 2) operands.push_back(arg);
+        else throw InvalidOptionException(arg);
+    }
+
+    if (operands.size() != 2) throw InvalidOperationException("sed needs a script and a file");
+
+    const Substitution substitution{operands[0], extended};
+    if (inPlace) {
+        fsManager.substitute(operands[1], substitution);
+        return;
+    }
+
+    utility::BufferedWriter out{std::cout};
+    fsManager.substitute(operands[1], substitution, [&] (std::string_view text) { out << text; });
+}
+
+// ---------------- HISTORYCommand ----------------
+void HISTORYCommand::execute([[maybe_unused]] FileSystemManager& fsManager, const std::vector<std::string>& args)
+{
+    const History& history{History::instance()};
+    std::size_t first{};
+
+    if (!args.empty()) first = history.size() - std::min(utility::parseCount(args[0]), history.size());
+
+    utility::BufferedWriter out{std::cout};
+    for (std::size_t i{first}; i < history.size(); ++i) {
+        const std::string number{std::to_string(i + 1)};
+        if (number.size() < 5) out << std::string(5 - number.size(), ' ');
+        out << number << "  " << history.entry(i) << '\n';
+    }
+}
@@ -0,0 +1,240 @@
+#include "../include/ContentHash.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace {
+
+constexpr std::uint64_t prime1{11400714785074694791ULL};
+constexpr std::uint64_t prime2{14029467366897019727ULL};
+constexpr std::uint64_t prime3{1609587929392839161ULL};
+constexpr std::uint64_t prime4{9650029242287828579ULL};
+constexpr std::uint64_t prime5{2870177450012600261ULL};
+
+inline std::uint64_t readLE64(const unsigned char* p) noexcept
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+        std::uint64_t r{};
+        for (int i{}; i < 8; ++i) r |= std::uint64_t{p[i]} << (8 * i);
+        v = r;
+    }
+    return v;
+}
+
+inline std::uint32_t readLE32(const unsigned char* p) noexcept
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big) {
+        v = std::uint32_t{p[0]} | std::uint32_t{p[1]} << 8 | std::uint32_t{p[2]} << 16 | std::uint32_t{p[3]} << 24;
+    }
+    return v;
+}
+
+inline std::uint64_t round(std::uint64_t acc, std::uint64_t input) noexcept
+{
+    acc += input * prime2;
+    acc = std::rotl(acc, 31);
+    return acc * prime1;
+}
+
+inline std::uint64_t mergeRound(std::uint64_t acc, std::uint64_t value) noexcept
+{
+    acc ^= round(0, value);
+    return acc * prime1 + prime4;
+}
+
+constexpr std::array<std::uint32_t, 64> shaRounds{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+} // namespace
+
+// ---------------- Xxh64 ----------------
+Xxh64::Xxh64(std::uint64_t seed) noexcept
+    : acc{seed + prime1 + prime2, seed + prime2, seed, seed - prime1}, buffer{}, seed{seed}
+{
+}
+
+void Xxh64::update(std::string_view data) noexcept
+{
+    const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+    std::size_t size{data.size()};
+    totalLength += size;
+
+    // Tops up a partial stripe first.
+    if (buffered > 0) {
+        const std::size_t take{std::min(size, buffer.size() - buffered)};
+        std::memcpy(buffer.data() + buffered, p, take);
+        buffered += take;
+        p += take;
+        size -= take;
+        if (buffered < buffer.size()) return;
+
+        for (std::size_t lane{}; lane < 4; ++lane) acc[lane] = round(acc[lane], readLE64(buffer.data() + 8 * lane));
+        buffered = 0;
+    }
+
+    for (; size >= 32; p += 32, size -= 32) {
+        acc[0] = round(acc[0], readLE64(p));
+        acc[1] = round(acc[1], readLE64(p + 8));
+        acc[2] = round(acc[2], readLE64(p + 16));
+        acc[3] = round(acc[3], readLE64(p + 24));
+    }
+
+    std::memcpy(buffer.data(), p, size);
+    buffered = size;
+}
+
+std::uint64_t Xxh64::digest() const noexcept
+{
+    std::uint64_t h;
+    if (totalLength >= 32) {
+        h = std::rotl(acc[0], 1) + std::rotl(acc[1], 7) + std::rotl(acc[2], 12) + std::rotl(acc[3], 18);
+        for (std::uint64_t lane : acc) h = mergeRound(h, lane);
+    }
+    else {
+        h = seed + prime5;
+    }
+    h += totalLength;
+
+    const unsigned char* p{buffer.data()};
+    std::size_t size{buffered};
+    for (; size >= 8; p += 8, size -= 8) {
+        h ^= round(0, readLE64(p));
+        h = std::rotl(h, 27) * prime1 + prime4;
+    }
+    if (size >= 4) {
+        h ^= std::uint64_t{readLE32(p)} * prime1;
+        h = std::rotl(h, 23) * prime2 + prime3;
+        p += 4;
+        size -= 4;
+    }
+    for (; size > 0; ++p, --size) {
+        h ^= *p * prime5;
+        h = std::rotl(h, 11) * prime1;
+    }
+
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+// ---------------- Sha256 ----------------
+Sha256::Sha256() noexcept
+    : state{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}, buffer{}
+{
+}
+
+void Sha256::compress(const unsigned char* block) noexcept
+{
+    std::array<std::uint32_t, 64> w;
+    for (std::size_t i{}; i < 16; ++i) {
+        w[i] = std::uint32_t{block[4 * i]} << 24 | std::uint32_t{block[4 * i + 1]} << 16
+             | std::uint32_t{block[4 * i + 2]} << 8 | std::uint32_t{block[4 * i + 3]};
+    }
+    for (std::size_t i{16}; i < 64; ++i) {
+        const std::uint32_t s0{std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3)};
+        const std::uint32_t s1{std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10)};
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state;
+    for (std::size_t i{}; i < 64; ++i) {
+        const std::uint32_t s1{std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)};
+        const std::uint32_t choice{(e & f) ^ (~e & g)};
+        const std::uint32_t t1{h + s1 + choice + shaRounds[i] + w[i]};
+        const std::uint32_t s0{std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)};
+        const std::uint32_t majority{(a & b) ^ (a & c) ^ (b & c)};
+        const std::uint32_t t2{s0 + majority};
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void Sha256::update(std::string_view data) noexcept
+{
+    const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+    std::size_t size{data.size()};
+    totalLength += size;
+
+    if (buffered > 0) {
+        const std::size_t take{std::min(size, buffer.size() - buffered)};
+        std::memcpy(buffer.data() + buffered, p, take);
+        buffered += take;
+        p += take;
+        size -= take;
+        if (buffered < buffer.size()) return;
+
+        compress(buffer.data());
+        buffered = 0;
+    }
+
+    for (; size >= 64; p += 64, size -= 64) compress(p);
+
+    std::memcpy(buffer.data(), p, size);
+    buffered = size;
+}
+
+Sha256::Digest Sha256::digest() const noexcept
+{
+    // Pads a copy, so the stream can continue afterwards.
+    Sha256 tail{*this};
+    const std::uint64_t bits{totalLength * 8};
+
+    const unsigned char one{0x80};
+    tail.update({reinterpret_cast<const char*>(&one), 1});
+    const unsigned char zeros[64]{};
+    tail.update({reinterpret_cast<const char*>(zeros), (tail.buffered <= 56 ? 56 : 120) - tail.buffered});
+
+    unsigned char length[8];
+    for (std::size_t i{}; i < 8; ++i) length[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+    tail.update({reinterpret_cast<const char*>(length), sizeof(length)});
+
+    Digest res;
+    for (std::size_t i{}; i < 8; ++i) {
+        for (std::size_t j{}; j < 4; ++j) res[4 * i + j] = static_cast<std::uint8_t>(tail.state[i] >> (24 - 8 * j));
+    }
+    return res;
+}
+
+// ---------------- Hex ----------------
+std::string toHex(const unsigned char* data, std::size_t size)
+{
+    static constexpr char digits[]{"0123456789abcdef"};
+    std::string res(2 * size, '0');
+    for (std::size_t i{}; i < size; ++i) {
+        res[2 * i] = digits[data[i] >> 4];
+        res[2 * i + 1] = digits[data[i] & 0xf];
+    }
+    return res;
+}
+
+std::string toHex(std::uint64_t value)
+{
+    unsigned char bytes[8];
+    for (std::size_t i{}; i < 8; ++i) bytes[i] = static_cast<unsigned char>(value >> (56 - 8 * i));
+    return toHex(bytes, sizeof(bytes));
+}
@@ -1,14 +1,12 @@
 #include "../include/Directory.hpp"
 #include "../include/File.hpp"
+#include "../include/Symlink.hpp"
+#include "../include/WatchManager.hpp"
 
-std::size_t Directory::getSize() const
+Usage Directory::getUsage() const noexcept
 {
-    std::size_t res{};
-    for (const auto& [_, node] : children) {
-        ++res;
-        if (node->isDirectory()) res += node->getSize();
-    }
-
+    Usage res{subtreeUsage};
+    res += {0, 0, 1, nodeName.size()};
     return res;
 }
 
@@ -22,9 +20,7 @@ void Directory::mkdir(const std::string& name)
         throw DirectoryAlreadyExists(name);
     }
 
-    auto newDirectory = std::make_shared<Directory>(name);
-    newDirectory->setParent(shared_from_this());
-    children[name] = newDirectory;
+    addChild(std::make_shared<Directory>(name));
 }
 
 void Directory::rmEmptyDir(const std::string& name)
@@ -78,7 +74,29 @@ void Directory::rmFile(const std::string& name)
 
 void Directory::removeChild(const std::string& name) noexcept
 {
-    children.erase(name);
+    auto it = children.find(name);
+    if (it == children.end()) return;
+
+    Usage removed{it->second->getUsage()};
+    const bool directory{it->second->isDirectory()};
+    it->second->setParent(nullptr);
+    children.erase(it);
+    ++structureGeneration;
+    propagateUsage({}, removed);
+    invalidateTreeHash();
+    MetadataStore::instance().onModify(this);
+    if (WatchManager::enabled()) WatchManager::instance().publish(WatchEvent::Type::DELETE, *this, name, directory);
+}
+
+void Directory::propagateUsage(const Usage& added, const Usage& removed) noexcept
+{
+    subtreeUsage += added;
+    subtreeUsage -= removed;
+
+    for (auto dir = parent.lock(); dir != nullptr; dir = dir->parent.lock()) {
+        dir->subtreeUsage += added;
+        dir->subtreeUsage -= removed;
+    }
 }
 
 void Directory::createOrUpdateFile(const std::string& name)
@@ -86,12 +104,12 @@ void Directory::createOrUpdateFile(const std::string& name)
     auto it = children.find(name);
     if (it != children.end()) {
         if (it->second->isDirectory()) throw InvalidOperationException("Directory with name: " + name + " already exists");
+        MetadataStore::instance().onModify(it->second.get());
+        if (WatchManager::enabled()) WatchManager::instance().publish(WatchEvent::Type::MODIFY, *this, name, false);
         return;
     }
 
-    auto newFile = std::make_shared<File>(name);
-    newFile->setParent(shared_from_this());
-    children[name] = newFile;
+    addChild(std::make_shared<File>(name));
 }
 
 
@@ -104,7 +122,58 @@ void Directory::addChild(std::shared_ptr<FileSystemNode> child)
     }
 
     child->setParent(shared_from_this());
-    children[childName] = child;
+    children.emplace(child);
+    ++structureGeneration;
+    propagateUsage(child->getUsage(), {});
+    invalidateTreeHash();
+    MetadataStore::instance().onModify(this);
+    if (WatchManager::enabled()) WatchManager::instance().publish(WatchEvent::Type::CREATE, *this, childName, child->isDirectory());
+}
+
+void Directory::invalidateTreeHash() noexcept
+{
+    if (!treeHashValid) return;
+    treeHashValid = false;
+
+    for (auto dir = parent.lock(); dir != nullptr && dir->treeHashValid; dir = dir->parent.lock()) {
+        dir->treeHashValid = false;
+    }
+}
+
+std::uint64_t Directory::treeHash() const
+{
+    if (treeHashValid) return cachedTreeHash;
+
+    // Each child is framed as kind, name length, name, hash so that no two
+    // different listings feed the same bytes. A symbolic link hashes its target path.
+    Xxh64 state;
+    for (const auto& [name, child] : children) {
+        std::uint64_t childHash{};
+        switch (child->kind()) {
+            case Kind::FILE:      childHash = nodeCast<File>(*child).xxh64(); break;
+            case Kind::DIRECTORY: childHash = nodeCast<Directory>(*child).treeHash(); break;
+            case Kind::SYMLINK: {
+                Xxh64 target;
+                target.update(nodeCast<Symlink>(*child).target());
+                childHash = target.digest();
+                break;
+            }
+        }
+
+        unsigned char header[9];
+        header[0] = static_cast<unsigned char>(child->kind());
+        for (std::size_t i{}; i < 8; ++i) header[1 + i] = static_cast<unsigned char>(std::uint64_t{name.size()} >> (8 * i));
+        state.update({reinterpret_cast<const char*>(header), sizeof(header)});
+        state.update(name);
+
+        unsigned char hash[8];
+        for (std::size_t i{}; i < 8; ++i) hash[i] = static_cast<unsigned char>(childHash >> (8 * i));
+        state.update({reinterpret_cast<const char*>(hash), sizeof(hash)});
+    }
+
+    cachedTreeHash = state.digest();
+    treeHashValid = true;
+    return cachedTreeHash;
 }
 
 std::string Directory::getFullPath() const
@@ -127,11 +196,12 @@ std::string Directory::getFullPath() const
     return res;
 }
 
-std::vector<std::string> Directory::ls() const
+std::vector<std::string> Directory::ls(std::string_view prefix) const
 {
     std::vector<std::string> res;
-    for (const auto& [childName, _] : children) {
-        res.push_back(childName);
+    auto [first, last] = children.prefixRange(prefix);
+    for (auto it = first; it != last; ++it) {
+        res.push_back(it->first);
     }
 
     return res;
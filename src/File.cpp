@@ -1,8 +1,152 @@
 #include "../include/File.hpp"
+#include "../include/Directory.hpp"
+#include "../include/WatchManager.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+File::File(const std::string& name, File& target)
+    : FileSystemNode{name, staticKind}, body{target.body}, nextLink{target.nextLink}
+{
+    target.nextLink = this;
+}
+
+File::~File()
+{
+    File* prev{this};
+    while (prev->nextLink != this) prev = prev->nextLink;
+    prev->nextLink = nextLink;
+}
 
 void File::write(const std::string& message, bool append)
 {
-    if (!append) fileContent.clear();
+    const std::size_t oldSize{body->content.size()};
+
+    if (!append) {
+        body->content.clear();
+        dropCaches();
+    }
+
+    const std::size_t from{body->content.size()};
+    body->content += message;
+    body->content += '\n';
+    cachesAppended(from);
+    contentChanged(oldSize);
+}
+
+void File::writeAt(std::size_t offset, std::string_view data)
+{
+    const std::size_t oldSize{body->content.size()};
+
+    body->content.replace(offset, std::min(data.size(), oldSize - offset), data);
+    if (offset == oldSize) cachesAppended(oldSize);
+    else dropCaches();
+    contentChanged(oldSize);
+}
+
+void File::assign(std::string content)
+{
+    const std::size_t oldSize{body->content.size()};
+
+    body->content = std::move(content);
+    dropCaches();
+    contentChanged(oldSize);
+}
+
+std::string_view File::head(std::size_t lines) const noexcept
+{
+    const char* data{body->content.data()};
+    std::size_t end{};
+    for (std::size_t i{}; i < lines; ++i) {
+        const void* newline{std::memchr(data + end, '\n', body->content.size() - end)};
+        if (!newline) return body->content;
+        end = static_cast<std::size_t>(static_cast<const char*>(newline) - data) + 1;
+    }
+
+    return std::string_view{body->content}.substr(0, end);
+}
+
+std::string_view File::tail(std::size_t lines) const noexcept
+{
+    const std::string_view content{body->content};
+    if (lines == 0) return content.substr(content.size());
+
+    // start marks the end of the line above everything kept so far.
+    std::size_t start{content.size()};
+    if (!content.empty() && content.back() == '\n') --start;
+
+    for (std::size_t i{}; i < lines; ++i) {
+        if (start == 0) return content;
+        const std::size_t newline{content.rfind('\n', start - 1)};
+        if (newline == std::string_view::npos) return content;
+        start = newline;
+    }
+
+    return content.substr(start + 1);
+}
+
+const TextStats& File::stats() const
+{
+    if (!body->cachedStats) body->cachedStats = TextStats::count(body->content);
+    return *body->cachedStats;
+}
+
+std::uint64_t File::xxh64() const
+{
+    if (!body->hashes) body->hashes = std::make_unique<HashStates>();
+    if (!body->hashes->xxh64) body->hashes->xxh64.emplace().update(body->content);
+    return body->hashes->xxh64->digest();
+}
+
+Sha256::Digest File::sha256() const
+{
+    if (!body->hashes) body->hashes = std::make_unique<HashStates>();
+    if (!body->hashes->sha256) body->hashes->sha256.emplace().update(body->content);
+    return body->hashes->sha256->digest();
+}
+
+void File::cachesAppended(std::size_t from) noexcept
+{
+    const std::string_view added{std::string_view{body->content}.substr(from)};
+
+    if (body->cachedStats) {
+        const bool afterWord{from > 0 && !TextStats::isSpace(body->content[from - 1])};
+        *body->cachedStats += TextStats::count(added, afterWord);
+    }
+
+    if (body->hashes) {
+        if (body->hashes->xxh64) body->hashes->xxh64->update(added);
+        if (body->hashes->sha256) body->hashes->sha256->update(added);
+    }
+}
+
+void File::dropCaches() noexcept
+{
+    body->cachedStats.reset();
+    body->hashes.reset();
+}
+
+std::size_t File::linkCount() const noexcept
+{
+    std::size_t count{1};
+    for (const File* link{nextLink}; link != this; link = link->nextLink) ++count;
+    return count;
+}
+
+void File::contentChanged(std::size_t oldSize)
+{
+    const std::size_t newSize{body->content.size()};
+    File* link{this};
+    do {
+        MetadataStore::instance().onModify(link);
+
+        if (auto dir = link->parent.lock()) {
+            if (newSize > oldSize) dir->propagateUsage({newSize - oldSize}, {});
+            else if (newSize < oldSize) dir->propagateUsage({}, {oldSize - newSize});
+            dir->invalidateTreeHash();
 
-    fileContent += message + "\n";
-}
\ No newline at end of file
+            if (WatchManager::enabled()) WatchManager::instance().publish(WatchEvent::Type::MODIFY, *dir, link->nodeName, false);
+        }
+        link = link->nextLink;
+    } while (link != this);
+}
@@ -1,7 +1,72 @@
 #include "../include/FileSystemManager.hpp"
 #include "../include/FileSystemException.hpp"
+#include "../include/LineDiff.hpp"
+#include "../include/Tracer.hpp"
+#include "../include/WatchManager.hpp"
 #include "../utility/Utils.hpp"
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/// @brief Writes content to a host file, truncating it, straight from the given buffer.
+void writeHostFile(const std::filesystem::path& path, std::string_view content)
+{
+    const int fd{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)};
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "Cannot create " + path.string());
+
+    while (!content.empty()) {
+        const ssize_t written{::write(fd, content.data(), content.size())};
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            const int error{errno};
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Cannot write " + path.string());
+        }
+        content.remove_prefix(static_cast<std::size_t>(written));
+    }
+
+    if (::close(fd) != 0) throw std::system_error(errno, std::generic_category(), "Cannot write " + path.string());
+}
+
+/**
+ * @brief Target for the host copy of a symbolic link in an exported tree.
+ * @param root Virtual path of the exported directory.
+ * @param linkDir Virtual path of the directory holding the link.
+ * @param target Target of the link.
+ * @return The target relative to linkDir if it was absolute, as it is otherwise,
+ *         or nothing if it points outside root and would leave the export.
+ */
+std::optional<std::filesystem::path> hostLinkTarget(const std::filesystem::path& root, const std::filesystem::path& linkDir, const std::string& target)
+{
+    const std::filesystem::path path{target};
+    const std::filesystem::path resolved{(path.is_absolute() ? path : linkDir / path).lexically_normal()};
+    const std::filesystem::path inRoot{resolved.lexically_relative(root)};
+    if (inRoot.empty() || *inRoot.begin() == "..") return std::nullopt;
+
+    return path.is_absolute() ? resolved.lexically_relative(linkDir) : path;
+}
+
+/// @brief Hex digest of a file's content, from the hash state cached on the file.
+std::string digestHex(const File& file, HashAlgorithm algorithm)
+{
+    if (algorithm == HashAlgorithm::XXH64) return toHex(file.xxh64());
+
+    const Sha256::Digest digest{file.sha256()};
+    return toHex(digest.data(), digest.size());
+}
+
+} // namespace
 
 
 FileSystemManager::FileSystemManager(): root{std::make_shared<Directory>("")}, cwd{root} {}
@@ -23,6 +88,244 @@ std::vector<std::string> FileSystemManager::ls(const std::string& path) const
     return node->ls();
 }
 
+std::optional<std::string> FileSystemManager::lsPage(const std::string& path, std::string_view after, std::size_t limit,
+                                                     const std::function<void(const std::string&, const FileSystemNode&)>& visit) const
+{
+    auto node = cwd;
+    if (!path.empty()) node = navigateToDirectory(path, node);
+
+    const std::string* last{nullptr};
+    const bool more = node->forEachChild(after, limit, [&] (const std::string& name, const FileSystemNode& child) {
+        visit(name, child);
+        last = &name;
+    });
+
+    if (!more) return std::nullopt;
+    return last ? *last : std::string{after};
+}
+
+void FileSystemManager::walk(const std::string& path, std::size_t maxDepth,
+                             const std::function<void(const std::string&, const FileSystemNode&, std::size_t, bool)>& visit) const
+{
+    auto start = cwd;
+    if (!path.empty()) start = navigateToDirectory(path, start);
+    TraceSpan span{"traverse", "fs", path};
+
+    // One cursor per open directory; the top one is the next child to visit.
+    struct Frame { const Directory* dir; ChildrenMap::iterator next; };
+    std::vector<Frame> stack;
+    if (maxDepth > 0) stack.push_back({start.get(), start->children.begin()});
+
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        if (top.next == top.dir->children.end()) {
+            stack.pop_back();
+            continue;
+        }
+
+        const auto& [name, child] = *top.next;
+        const bool last{++top.next == top.dir->children.end()};
+        const std::size_t depth{stack.size()};
+        visit(name, *child, depth, last);
+
+        if (child->isDirectory() && depth < maxDepth) {
+            const Directory* dir{&nodeCast<Directory>(*child)};
+            stack.push_back({dir, dir->children.begin()});
+        }
+    }
+}
+
+void FileSystemManager::walkDirectories(const std::string& path, const std::function<void(const std::string&, const Directory&)>& visit) const
+{
+    auto start = cwd;
+    if (!path.empty()) start = navigateToDirectory(path, start);
+    TraceSpan span{"traverse", "fs", path};
+
+    // One cursor per open directory, pointing past the subdirectories already visited.
+    struct Frame { const Directory* dir; ChildrenMap::iterator next; std::string path; };
+    std::vector<Frame> stack;
+
+    std::string startPath{path.empty() ? "." : path};
+    visit(startPath, *start);
+    stack.push_back({start.get(), start->children.begin(), std::move(startPath)});
+
+    while (!stack.empty()) {
+        Frame& top = stack.back();
+        const auto end = top.dir->children.end();
+        while (top.next != end && !top.next->second->isDirectory()) ++top.next;
+        if (top.next == end) {
+            stack.pop_back();
+            continue;
+        }
+
+        const auto& [name, child] = *top.next;
+        ++top.next;
+
+        std::string childPath{top.path};
+        if (childPath.back() != '/') childPath += '/';
+        childPath += name;
+
+        const Directory* dir{&nodeCast<Directory>(*child)};
+        visit(childPath, *dir);
+        stack.push_back({dir, dir->children.begin(), std::move(childPath)});
+    }
+}
+
+FileSystemManager::Completion FileSystemManager::complete(const std::string& partial, std::size_t maxCandidates) const
+{
+    Completion res;
+
+    const std::size_t slash{partial.rfind('/')};
+    const std::string_view leaf{slash == std::string::npos ? std::string_view{partial} : std::string_view{partial}.substr(slash + 1)};
+
+    auto dir = cwd;
+    if (slash != std::string::npos) {
+        try {
+            dir = navigateToDirectory(slash == 0 ? "/" : partial.substr(0, slash), cwd);
+        }
+        catch (const FileSystemException&) {
+            return res;
+        }
+    }
+
+    auto [first, last] = dir->children.prefixRange(leaf);
+    if (first == last) return res;
+
+    const std::string& lo{first->first};
+    const std::string& hi{std::prev(last)->first};
+    const auto common = std::mismatch(lo.begin(), lo.end(), hi.begin(), hi.end());
+    res.common.assign(lo.begin(), common.first);
+
+    res.unique = std::next(first) == last;
+    if (res.unique && first->second->isDirectory()) res.common += '/';
+
+    auto it = first;
+    for (; it != last && res.candidates.size() < maxCandidates; ++it) {
+        res.candidates.push_back(it->first + (it->second->isDirectory() ? "/" : ""));
+    }
+
+    res.truncated = it != last;
+    return res;
+}
+
+FileSystemManager::GlobCursor FileSystemManager::glob(const std::string& pattern) const
+{
+    TraceSpan span{"resolve", "fs", pattern};
+    GlobCursor cursor;
+
+    const std::vector<std::string> components{utility::split(pattern)};
+    if (components.empty()) return cursor;
+
+    // Leading components without wildcards name the directory to start from.
+    std::size_t first{};
+    while (first + 1 < components.size() && !GlobPattern::hasWildcard(components[first])) ++first;
+
+    std::string prefix{pattern[0] == '/' ? "/" : ""};
+    for (std::size_t i{}; i < first; ++i) {
+        if (i > 0) prefix += '/';
+        prefix += GlobPattern::unescape(components[i]);
+    }
+
+    for (std::size_t i{first}; i < components.size(); ++i) cursor.parts.emplace_back(components[i]);
+    if (cursor.parts.back().isRecursive()) cursor.parts.emplace_back("*");
+
+    // A directory prefix that does not resolve leaves nothing to match.
+    std::shared_ptr<Directory> start{cwd};
+    if (!prefix.empty()) {
+        try {
+            start = navigateToDirectory(prefix, cwd);
+        }
+        catch (const FileSystemException&) {
+            return cursor;
+        }
+    }
+
+    cursor.frames.push_back({std::move(start), std::move(prefix), 0, {}});
+    return cursor;
+}
+
+bool FileSystemManager::nextMatch(GlobCursor& cursor, std::string& path) const
+{
+    auto join = [] (const std::string& dir, const std::string& name) {
+        if (dir.empty()) return name;
+        return dir.back() == '/' ? dir + name : dir + "/" + name;
+    };
+
+    while (!cursor.frames.empty()) {
+        auto& frame = cursor.frames.back();
+        const GlobPattern& part = cursor.parts[frame.part];
+        const ChildrenMap& children = frame.dir->children;
+
+        if (part.isRecursive()) {
+            // First match the rest of the pattern here, then descend one directory at a time.
+            if (!frame.started) {
+                frame.started = true;
+                GlobCursor::Frame here{frame.dir, frame.path, frame.part + 1, {}};
+                cursor.frames.push_back(std::move(here));
+                continue;
+            }
+
+            auto it = frame.after.empty() ? children.begin() : children.upperBound(frame.after);
+            while (it != children.end() && !it->second->isDirectory()) ++it;
+            if (it == children.end()) {
+                cursor.frames.pop_back();
+                continue;
+            }
+
+            frame.after = it->first;
+            GlobCursor::Frame sub{asNode<Directory>(it->second), join(frame.path, it->first), frame.part, {}};
+            cursor.frames.push_back(std::move(sub));
+            continue;
+        }
+
+        // A literal component has at most one match.
+        if (part.isLiteral() && !frame.after.empty()) {
+            cursor.frames.pop_back();
+            continue;
+        }
+
+        const bool lastPart{frame.part + 1 == cursor.parts.size()};
+        const std::string& prefix{part.literalPrefix()};
+
+        // Only children sharing the literal prefix are candidates, and they are contiguous.
+        auto it = frame.after.empty() ? children.prefixRange(prefix).first : children.upperBound(frame.after);
+        while (it != children.end() && it->first.starts_with(prefix)
+               && (!part.matches(it->first) || (!lastPart && !it->second->isDirectory()))) {
+            ++it;
+        }
+
+        if (it == children.end() || !it->first.starts_with(prefix)) {
+            cursor.frames.pop_back();
+            continue;
+        }
+
+        frame.after = it->first;
+        if (lastPart) {
+            path = join(frame.path, it->first);
+            return true;
+        }
+
+        GlobCursor::Frame sub{asNode<Directory>(it->second), join(frame.path, it->first), frame.part + 1, {}};
+        cursor.frames.push_back(std::move(sub));
+    }
+
+    return false;
+}
+
+FileSystemManager::NodeInfo FileSystemManager::stat(const std::string& path) const
+{
+    return describe(*findNode(path, false), path);
+}
+
+FileSystemManager::NodeInfo FileSystemManager::describe(const FileSystemNode& node, const std::string& name) const
+{
+    // A link's size is the length of its target, as lstat reports it.
+    NodeInfo info{name, node.kind(), node.isSymlink() ? node.getSize() : node.getUsage().bytes, 1, {}, node.getMetadata()};
+    if (node.kind() == FileSystemNode::Kind::FILE) info.links = nodeCast<File>(node).linkCount();
+    else if (node.isSymlink()) info.target = nodeCast<Symlink>(node).target();
+    return info;
+}
+
 void FileSystemManager::mkdir(const std::string& name)
 {
     cwd->mkdir(name);
@@ -36,7 +339,11 @@ void FileSystemManager::rmdir(const std::string& name, bool recursive)
 
 void FileSystemManager::rm(const std::string& name)
 {
-    cwd->rmFile(name);
+    if (name.find('/') == std::string::npos) return cwd->rmFile(name);
+
+    auto [dir, leaf] = resolveParent(name);
+    if (leaf.empty() || leaf == "." || leaf == "..") throw InvalidOperationException("Target is not a file: " + name);
+    dir->rmFile(leaf);
 }
 
 void FileSystemManager::touch(const std::string& name)
@@ -52,27 +359,276 @@ void FileSystemManager::writeToFile(const std::string& fileName, const std::stri
         it = cwd->children.find(fileName);
     }
 
-    if (it->second->isDirectory()) {
+    // Writing through a symbolic link writes its target.
+    std::size_t hops{};
+    const std::shared_ptr<FileSystemNode> node{it->second->isSymlink() ? followSymlink(nodeCast<Symlink>(*it->second), hops) : it->second};
+    if (node->isDirectory()) {
         throw InvalidPathException(fileName + " is not a file");
     }
 
-    auto fileNode = asNode<File>(it->second);
-    fileNode->write(message, append);
+    nodeCast<File>(*node).write(message, append);
 }
 
 std::string FileSystemManager::readFile(const std::string& fileName) const
 {
-    auto it = cwd->children.find(fileName);
-    if (it == cwd->children.end()) {
+    return findFile(fileName).read();
+}
+
+std::string FileSystemManager::realPath(const std::string& path) const
+{
+    auto [dir, leaf] = resolveParent(path);
+    if (leaf.empty() || leaf == "." || leaf == "..") return dir->getFullPath();
+    if (!dir->children.contains(leaf)) throw InvalidPathException(leaf);
+
+    std::string res{dir->getFullPath()};
+    if (res.back() != '/') res += '/';
+    return res + leaf;
+}
+
+std::string_view FileSystemManager::readRange(const std::string& fileName, std::size_t offset, std::size_t length) const
+{
+    const std::string_view content{findFile(fileName).getContent()};
+    if (offset > content.size()) throw InvalidOperationException("Offset is past the end of " + fileName);
+    return content.substr(offset, length);
+}
+
+std::string_view FileSystemManager::head(const std::string& fileName, std::size_t lines) const
+{
+    return findFile(fileName).head(lines);
+}
+
+std::string_view FileSystemManager::tail(const std::string& fileName, std::size_t lines) const
+{
+    return findFile(fileName).tail(lines);
+}
+
+void FileSystemManager::writeAt(const std::string& fileName, std::size_t offset, std::string_view data)
+{
+    File& file{findFile(fileName)};
+    if (offset > file.getSize()) throw InvalidOperationException("Offset is past the end of " + fileName);
+    file.writeAt(offset, data);
+}
+
+void FileSystemManager::appendTo(const std::string& fileName, std::string_view data)
+{
+    File& file{findFile(fileName)};
+    file.writeAt(file.getSize(), data);
+}
+
+TextStats FileSystemManager::wc(const std::string& fileName) const
+{
+    return findFile(fileName).stats();
+}
+
+std::string FileSystemManager::hash(const std::string& fileName, HashAlgorithm algorithm) const
+{
+    return digestHex(findFile(fileName), algorithm);
+}
+
+void FileSystemManager::hashTree(const std::string& path, HashAlgorithm algorithm,
+                                 const std::function<void(const std::string&, const std::string&)>& visit) const
+{
+    const std::shared_ptr<FileSystemNode> node{path.empty() ? cwd : findNode(path)};
+    if (!node->isDirectory()) {
+        visit(path, digestHex(nodeCast<File>(*node), algorithm));
+        return;
+    }
+
+    // Path of the open directory at each depth, ending with '/' unless empty.
+    std::vector<std::string> prefixes{path.empty() || path.back() == '/' ? path : path + "/"};
+    walk(path, std::numeric_limits<std::size_t>::max(), [&] (const std::string& name, const FileSystemNode& child, std::size_t depth, bool) {
+        std::string childPath{prefixes[depth - 1] + name};
+        if (child.isDirectory()) {
+            prefixes.resize(depth);
+            prefixes.push_back(childPath + "/");
+        }
+        else if (!child.isSymlink()) {
+            visit(childPath, digestHex(nodeCast<File>(child), algorithm));
+        }
+    });
+}
+
+std::size_t FileSystemManager::diffTree(const std::string& first, const std::string& second,
+                                       const std::function<void(const TreeChange&)>& visit) const
+{
+    const std::shared_ptr<FileSystemNode> a{first.empty() ? cwd : findNode(first)};
+    const std::shared_ptr<FileSystemNode> b{second.empty() ? cwd : findNode(second)};
+    TraceSpan span{"traverse", "fs", first};
+
+    if (a->isDirectory() != b->isDirectory()) {
+        visit({TreeChange::Type::TYPE_CHANGED, "", b->isDirectory()});
+        return 1;
+    }
+
+    if (!a->isDirectory()) {
+        if (nodeCast<File>(*a).xxh64() == nodeCast<File>(*b).xxh64()) return 0;
+        visit({TreeChange::Type::MODIFIED, "", false});
+        return 1;
+    }
+
+    const Directory& dirA{nodeCast<Directory>(*a)};
+    const Directory& dirB{nodeCast<Directory>(*b)};
+    if (dirA.treeHash() == dirB.treeHash()) return 0;
+    return diffDirectories(dirA, dirB, "", visit);
+}
+
+std::size_t FileSystemManager::diff(const std::string& first, const std::string& second, std::size_t context,
+                                   const std::function<void(std::string_view)>& write) const
+{
+    const File& a{findFile(first)};
+    const File& b{findFile(second)};
+    TraceSpan span{"diff", "fs", first};
+
+    const LineDiff diff{a.getContent(), b.getContent(), context};
+    if (diff.identical()) return 0;
+
+    write("--- " + first + "\n+++ " + second + "\n");
+    diff.writeUnified(write);
+    return diff.hunkCount();
+}
+
+std::vector<std::string_view> FileSystemManager::sort(const std::string& fileName, const SortOptions& options) const
+{
+    const File& file{findFile(fileName)};
+    TraceSpan span{"sort", "fs", fileName};
+    return sortLines(file.getContent(), options);
+}
+
+std::size_t FileSystemManager::sortToFile(const std::string& fileName, const SortOptions& options, const std::string& outputFile)
+{
+    auto [dir, leaf] = resolveParent(outputFile);
+    if (leaf.empty() || leaf == "." || leaf == "..") throw InvalidPathException(outputFile + " is not a file");
+
+    // The output is built in full before it is stored, as the lines may be views of it.
+    const std::vector<std::string_view> lines{sort(fileName, options)};
+    std::size_t size{};
+    for (std::string_view line : lines) size += line.size() + 1;
+    std::string sorted;
+    sorted.reserve(size);
+    for (std::string_view line : lines) {
+        sorted += line;
+        sorted += '\n';
+    }
+
+    if (!dir->children.contains(leaf)) dir->addChild(std::make_shared<File>(leaf));
+    findFile(outputFile).assign(std::move(sorted));
+    return lines.size();
+}
+
+void FileSystemManager::uniq(const std::string& fileName, const std::function<void(std::string_view, std::size_t)>& visit) const
+{
+    const std::string_view content{findFile(fileName).getContent()};
+
+    std::string_view run;
+    std::size_t count{};
+    std::size_t start{};
+    while (start < content.size()) {
+        const std::size_t newline{content.find('\n', start)};
+        const std::size_t end{newline == std::string_view::npos ? content.size() : newline};
+        const std::string_view line{content.substr(start, end - start)};
+        start = end + 1;
+
+        if (count > 0 && line == run) {
+            ++count;
+            continue;
+        }
+        if (count > 0) visit(run, count);
+        run = line;
+        count = 1;
+    }
+    if (count > 0) visit(run, count);
+}
+
+std::size_t FileSystemManager::substitute(const std::string& fileName, const Substitution& substitution)
+{
+    File& file{findFile(fileName)};
+    TraceSpan span{"sed", "fs", fileName};
+
+    PieceTable edits{file.getContent()};
+    const std::size_t count{substitution.apply(file.getContent(), edits)};
+    if (count > 0) file.assign(edits.toString());
+    return count;
+}
+
+std::size_t FileSystemManager::substitute(const std::string& fileName, const Substitution& substitution,
+                                          const std::function<void(std::string_view)>& write) const
+{
+    const File& file{findFile(fileName)};
+    TraceSpan span{"sed", "fs", fileName};
+
+    PieceTable edits{file.getContent()};
+    const std::size_t count{substitution.apply(file.getContent(), edits)};
+    edits.forEachPiece(write);
+    return count;
+}
+
+std::size_t FileSystemManager::diffDirectories(const Directory& first, const Directory& second, const std::string& prefix,
+                                               const std::function<void(const TreeChange&)>& visit) const
+{
+    // Both child maps are ordered by name, so one merge pass pairs them up.
+    std::size_t changes{};
+    auto itA = first.children.begin();
+    auto itB = second.children.begin();
+    const auto endA = first.children.end();
+    const auto endB = second.children.end();
+
+    while (itA != endA || itB != endB) {
+        const int order{itA == endA ? 1 : itB == endB ? -1 : itA->first.compare(itB->first)};
+        if (order < 0) {
+            visit({TreeChange::Type::DELETED, prefix + itA->first, itA->second->isDirectory()});
+            ++changes;
+            ++itA;
+            continue;
+        }
+        if (order > 0) {
+            visit({TreeChange::Type::ADDED, prefix + itB->first, itB->second->isDirectory()});
+            ++changes;
+            ++itB;
+            continue;
+        }
+
+        const FileSystemNode& a{*itA->second};
+        const FileSystemNode& b{*itB->second};
+        if (a.kind() != b.kind()) {
+            visit({TreeChange::Type::TYPE_CHANGED, prefix + itA->first, b.isDirectory()});
+            ++changes;
+        }
+        else if (a.isDirectory()) {
+            const Directory& dirA{nodeCast<Directory>(a)};
+            const Directory& dirB{nodeCast<Directory>(b)};
+            if (dirA.treeHash() != dirB.treeHash()) changes += diffDirectories(dirA, dirB, prefix + itA->first + "/", visit);
+        }
+        else if (a.isSymlink() ? nodeCast<Symlink>(a).target() != nodeCast<Symlink>(b).target()
+                               : nodeCast<File>(a).xxh64() != nodeCast<File>(b).xxh64()) {
+            visit({TreeChange::Type::MODIFIED, prefix + itA->first, false});
+            ++changes;
+        }
+
+        ++itA;
+        ++itB;
+    }
+
+    return changes;
+}
+
+File& FileSystemManager::findFile(const std::string& fileName) const
+{
+    auto [dir, leaf] = fileName.find('/') == std::string::npos ? std::pair{cwd, fileName} : resolveParent(fileName);
+    auto it = dir->children.find(leaf);
+    if (it == dir->children.end()) {
         throw FileDoesNotExist(fileName);
     }
 
-    if (it->second->isDirectory()) {
+    // The target of a link is owned by its own directory, so a raw pointer outlives the lookup.
+    FileSystemNode* node{it->second.get()};
+    std::size_t hops{};
+    if (node->isSymlink()) node = followSymlink(nodeCast<Symlink>(*node), hops).get();
+
+    if (node->isDirectory()) {
         throw InvalidPathException(fileName + " is not a file");
     }
 
-    auto fileNode = asNode<File>(it->second);
-    return fileNode->read();
+    return nodeCast<File>(*node);
 }
 
 void FileSystemManager::cp(const std::string& srcPath, const std::string& dstPath, bool recursive)
@@ -81,33 +637,50 @@ void FileSystemManager::cp(const std::string& srcPath, const std::string& dstPat
     auto dstNode = resolveDestination(dstPath);
 
     if (!fileName.empty()) {
-        auto fileNode = asNode<File>(parentDir->children[fileName]);
-        auto newFile = std::make_shared<File>(fileNode->getName(), fileNode->getContent());
-        dstNode->children[newFile->getName()] = newFile;
-        newFile->setParent(dstNode);
+        // A symbolic link is copied as a link by cp -r, otherwise its target is copied.
+        const std::shared_ptr<FileSystemNode>& src{parentDir->children.find(fileName)->second};
+        std::shared_ptr<FileSystemNode> copy;
+        if (src->isSymlink() && recursive) {
+            copy = std::make_shared<Symlink>(fileName, nodeCast<Symlink>(*src).target());
+        }
+        else {
+            std::size_t hops{};
+            const std::shared_ptr<FileSystemNode> node{src->isSymlink() ? followSymlink(nodeCast<Symlink>(*src), hops) : src};
+            if (node->isDirectory()) throw InvalidOperationException("Cannot non-recursively copy/move a directory");
+            copy = std::make_shared<File>(fileName, nodeCast<File>(*node).getContent());
+        }
+        const bool replaced{dstNode->children.contains(fileName)};
+        {
+            WatchManager::Mute mute;  // reported below as a single event
+            dstNode->removeChild(fileName);  // copying over an existing file replaces it
+            dstNode->addChild(std::move(copy));
+        }
+        if (WatchManager::enabled()) {
+            WatchManager::instance().publish(replaced ? WatchEvent::Type::MODIFY : WatchEvent::Type::CREATE, *dstNode, fileName, false);
+        }
     }
     else {
         validateCopyOrMove(srcNode, dstNode);
-        copyDirectory(srcNode, dstNode);
+        TraceSpan span{"traverse", "fs", srcPath};
+        copyDirectory(*srcNode, *dstNode);
     }
 }
 
-void FileSystemManager::copyDirectory(const std::shared_ptr<Directory>& srcNode, const std::shared_ptr<Directory>& dstNode)
+void FileSystemManager::copyDirectory(const Directory& srcNode, Directory& dstNode)
 {
-    auto newDir = std::make_shared<Directory>(srcNode->getName());
-    dstNode->children[newDir->getName()] = newDir;
-    newDir->setParent(dstNode);
+    auto newDir = std::make_shared<Directory>(srcNode.getName());
+    dstNode.addChild(newDir);
 
-    for (auto& [name, node] : srcNode->children) {
+    for (const auto& [name, node] : srcNode.children) {
         if (node->isDirectory()) {
-            auto dirNode = asNode<Directory>(node);
-            copyDirectory(dirNode, newDir);
+            copyDirectory(nodeCast<Directory>(*node), *newDir);
+        }
+        else if (node->isSymlink()) {
+            newDir->addChild(std::make_shared<Symlink>(name, nodeCast<Symlink>(*node).target()));
         }
         else {
-            auto fileNode = asNode<File>(node);
-            auto newFile = std::make_shared<File>(fileNode->getName(), fileNode->getContent());
-            newDir->children[newFile->getName()] = newFile;
-            newFile->setParent(newDir);
+            const File& file{nodeCast<File>(*node)};
+            newDir->addChild(std::make_shared<File>(file.getName(), file.getContent()));
         }
     }
 }
@@ -117,25 +690,78 @@ void FileSystemManager::mv(const std::string& srcPath, const std::string& dstPat
     auto [parentDir, fileName, srcNode] = resolveSource(srcPath, recursive);
     auto dstNode = resolveDestination(dstPath);
 
+    // A move is a remove and an add; watches get a single MOVE event instead.
+    const bool watched{WatchManager::enabled()};
+    WatchManager::Mute mute;
+    auto childPath = [] (const Directory& dir, const std::string& name) {
+        std::string path{dir.getFullPath()};
+        if (path.back() != '/') path += '/';
+        return path + name;
+    };
+
     if (!fileName.empty()) {
-        auto fileNode = asNode<File>(parentDir->children[fileName]);
-        parentDir->children.erase(fileName);
-        dstNode->children[fileName] = fileNode;
-        fileNode->setParent(dstNode);
+        auto fileNode = parentDir->children.find(fileName)->second;  // a file or a symbolic link, moved as is
+        std::string from{watched ? childPath(*parentDir, fileName) : std::string{}};
+        parentDir->removeChild(fileName);
+        dstNode->removeChild(fileName);  // moving over an existing file replaces it
+        dstNode->addChild(fileNode);
+        if (watched) WatchManager::instance().publishMove(from, childPath(*dstNode, fileName), false);
     }
     else {
         validateCopyOrMove(srcNode, dstNode);
 
+        std::string from{watched ? srcNode->getFullPath() : std::string{}};
         auto srcParentNode = srcNode->parent.lock();
-        srcParentNode->children.erase(srcNode->getName());
-        dstNode->children[srcNode->getName()] = srcNode;
-        srcNode->setParent(dstNode);
+        srcParentNode->removeChild(srcNode->getName());
+        dstNode->addChild(srcNode);
+        if (watched) WatchManager::instance().publishMove(from, srcNode->getFullPath(), true);
     }
 }
 
+void FileSystemManager::link(const std::string& target, const std::string& linkPath)
+{
+    const std::shared_ptr<FileSystemNode> node{findNode(target)};
+    if (node->isDirectory()) throw InvalidOperationException("Cannot hard link a directory: " + target);
+
+    auto [dir, name] = linkDestination(target, linkPath);
+    dir->addChild(std::make_shared<File>(name, nodeCast<File>(*node)));
+}
+
+void FileSystemManager::symlink(const std::string& target, const std::string& linkPath)
+{
+    if (target.empty()) throw InvalidPathException("Path cannot be empty");
+
+    auto [dir, name] = linkDestination(target, linkPath);
+    dir->addChild(std::make_shared<Symlink>(name, target));
+}
+
+std::pair<std::shared_ptr<Directory>, std::string> FileSystemManager::linkDestination(const std::string& target, const std::string& linkPath) const
+{
+    auto [dir, leaf] = resolveParent(linkPath);
+    if (!leaf.empty() && leaf != "." && leaf != "..") {
+        auto it = dir->children.find(leaf);
+        if (it == dir->children.end()) return {dir, leaf};
+
+        std::size_t hops{};
+        FileSystemNode* node{it->second.get()};
+        if (node->isSymlink()) node = followSymlink(nodeCast<Symlink>(*node), hops).get();
+        if (!node->isDirectory()) throw FileAlreadyExists(leaf);
+        dir = nodeCast<Directory>(*node).shared_from_this();
+    }
+
+    // Linking into a directory reuses the last component of the target.
+    std::string name{target};
+    while (name.size() > 1 && name.back() == '/') name.pop_back();
+    name = name.substr(name.rfind('/') + 1);
+    if (name.empty() || name == "." || name == "..") throw InvalidPathException(target);
+    if (dir->children.contains(name)) throw FileAlreadyExists(name);
+    return {dir, name};
+}
+
 auto FileSystemManager::resolveSource(const std::string& srcPath, bool recursive)
     -> std::tuple<std::shared_ptr<Directory>, std::string, std::shared_ptr<Directory>>
 {
+    TraceSpan span{"resolve", "fs", srcPath};
     auto srcNode = cwd;
     auto pathPrefix = utility::validatePath(srcPath);
     if (pathPrefix.type == utility::PathPrefix::StartType::ROOT) {
@@ -148,24 +774,34 @@ auto FileSystemManager::resolveSource(const std::string& srcPath, bool recursive
         }
     }
 
+    // Descend through raw pointers; ownership is only taken once, at the end.
+    // Links on the way are followed; a link as the last component is the source itself.
     std::vector<std::string> parts = utility::split(pathPrefix.rest);
     std::string fileName;
+    bool link{false};
+    std::size_t hops{};
+    Directory* dir{srcNode.get()};
     for (std::size_t i{}; i < parts.size(); ++i) {
         if (parts[i].empty()) continue;
 
-        auto it = srcNode->children.find(parts[i]);
-        if (it == srcNode->children.end()) throw InvalidPathException(parts[i]);
+        auto it = dir->children.find(parts[i]);
+        if (it == dir->children.end()) throw InvalidPathException(parts[i]);
 
-        if (!it->second->isDirectory()) {
+        FileSystemNode* child{it->second.get()};
+        if (child->isSymlink() && i != parts.size() - 1) child = followSymlink(nodeCast<Symlink>(*child), hops).get();
+
+        if (!child->isDirectory()) {
             if (i != parts.size() - 1) throw InvalidOperationException("File cannot contain a directory");
             fileName = parts[i];
+            link = child->isSymlink();
             break;
         }
 
-        srcNode = asNode<Directory>(it->second);
+        dir = &nodeCast<Directory>(*child);
     }
+    if (dir != srcNode.get()) srcNode = dir->shared_from_this();
 
-    if (!fileName.empty() && recursive) throw InvalidOperationException("Cannot recursively copy/move a file");
+    if (!fileName.empty() && recursive && !link) throw InvalidOperationException("Cannot recursively copy/move a file");
     if (fileName.empty() && !recursive) throw InvalidOperationException("Cannot non-recursively copy/move a directory");
 
     if (!fileName.empty()) {
@@ -178,6 +814,7 @@ auto FileSystemManager::resolveSource(const std::string& srcPath, bool recursive
 
 std::shared_ptr<Directory> FileSystemManager::resolveDestination(const std::string& dstPath)
 {
+    TraceSpan span{"resolve", "fs", dstPath};
     auto dstNode = cwd;
     auto pathPrefix = utility::validatePath(dstPath);
     if (pathPrefix.type == utility::PathPrefix::StartType::ROOT) {
@@ -190,17 +827,22 @@ std::shared_ptr<Directory> FileSystemManager::resolveDestination(const std::stri
         }
     }
 
+    Directory* dir{dstNode.get()};
+    std::size_t hops{};
     for (const auto& part : utility::split(pathPrefix.rest)) {
         if (part.empty()) continue;
 
-        auto it = dstNode->children.find(part);
-        if (it == dstNode->children.end()) throw InvalidPathException(part);
-        if (!it->second->isDirectory()) throw InvalidPathException(part + " is not a directory");
+        auto it = dir->children.find(part);
+        if (it == dir->children.end()) throw InvalidPathException(part);
 
-        dstNode = asNode<Directory>(it->second);
+        FileSystemNode* child{it->second.get()};
+        if (child->isSymlink()) child = followSymlink(nodeCast<Symlink>(*child), hops).get();
+        if (!child->isDirectory()) throw InvalidPathException(part + " is not a directory");
+
+        dir = &nodeCast<Directory>(*child);
     }
 
-    return dstNode;
+    return dir == dstNode.get() ? dstNode : dir->shared_from_this();
 }
 
 void FileSystemManager::validateCopyOrMove(const std::shared_ptr<Directory>& srcNode, const std::shared_ptr<Directory>& dstNode)
@@ -226,6 +868,7 @@ void FileSystemManager::validateCopyOrMove(const std::shared_ptr<Directory>& src
 
 std::shared_ptr<Directory> FileSystemManager::navigateToDirectory(const std::string& path, std::shared_ptr<Directory> startNode) const
 {
+    TraceSpan span{"resolve", "fs", path};
     auto node = startNode;
 
     auto pathPrefix = utility::validatePath(path);
@@ -239,21 +882,99 @@ std::shared_ptr<Directory> FileSystemManager::navigateToDirectory(const std::str
         }
     }
 
+    // Intermediate components are visited through raw pointers so that a deep
+    // path costs no reference-count traffic; only the result is shared.
+    // Links are followed from their cached target, which the tree keeps alive.
+    Directory* dir{node.get()};
+    std::size_t hops{};
     std::vector<std::string> actualPath = utility::split(pathPrefix.rest);
     for (const std::string& s : actualPath) {
         if (s.empty()) continue;
 
-        auto it = node->children.find(s);
-        if (it == node->children.end()) {
+        auto it = dir->children.find(s);
+        if (it == dir->children.end()) {
             throw DirectoryDoesNotExist(s);
         }
-        
-        if (!it->second->isDirectory()) {
+
+        FileSystemNode* child{it->second.get()};
+        if (child->isSymlink()) child = followSymlink(nodeCast<Symlink>(*child), hops).get();
+        if (!child->isDirectory()) {
             throw InvalidPathException(s + " is not a directory");
         }   
 
-        auto nextDir = asNode<Directory>(node->children[s]);
-        node = nextDir;
+        dir = &nodeCast<Directory>(*child);
+    }
+
+    return dir == node.get() ? node : dir->shared_from_this();
+}
+
+std::pair<std::shared_ptr<Directory>, std::string> FileSystemManager::resolveParent(const std::string& path) const
+{
+    // Everything but the last component must be a directory.
+    std::string trimmed{path};
+    while (trimmed.size() > 1 && trimmed.back() == '/') trimmed.pop_back();
+
+    const std::size_t slash{trimmed.rfind('/')};
+    std::string leaf{slash == std::string::npos ? trimmed : trimmed.substr(slash + 1)};
+    if (leaf.empty() || leaf == "." || leaf == "..") return {navigateToDirectory(trimmed, cwd), leaf};
+
+    if (slash == std::string::npos) return {cwd, std::move(leaf)};
+    if (slash == 0) return {root, std::move(leaf)};
+    return {navigateToDirectory(trimmed.substr(0, slash), cwd), std::move(leaf)};
+}
+
+std::shared_ptr<FileSystemNode> FileSystemManager::findNode(const std::string& path, bool follow) const
+{
+    auto [dir, leaf] = resolveParent(path);
+    if (leaf.empty() || leaf == "." || leaf == "..") return dir;
+
+    auto it = dir->children.find(leaf);
+    if (it == dir->children.end()) throw InvalidPathException(leaf);
+    if (!follow || !it->second->isSymlink()) return it->second;
+
+    std::size_t hops{};
+    return followSymlink(nodeCast<Symlink>(*it->second), hops);
+}
+
+std::shared_ptr<FileSystemNode> FileSystemManager::followSymlink(const Symlink& link, std::size_t& hops) const
+{
+    if (auto cached = link.cachedTarget()) return cached;
+
+    if (++hops > maxSymlinkHops) throw SymlinkLoopException(link.target());
+    auto dir = link.getParent();
+    if (!dir) throw InvalidPathException(link.target());
+
+    auto node = lookup(link.target(), std::move(dir), hops);
+    link.cacheTarget(node);
+    return node;
+}
+
+std::shared_ptr<FileSystemNode> FileSystemManager::lookup(const std::string& path, std::shared_ptr<Directory> start, std::size_t& hops) const
+{
+    auto pathPrefix = utility::validatePath(path);
+    if (pathPrefix.type == utility::PathPrefix::StartType::ROOT) {
+        start = root;
+    }
+    else {
+        int ups{pathPrefix.ups};
+        while (start != root && ups--) {
+            auto up = start->getParent();
+            if (!up) break;  // a directory removed from the tree has no parent left
+            start = std::move(up);
+        }
+    }
+
+    std::shared_ptr<FileSystemNode> node{std::move(start)};
+    for (const std::string& part : utility::split(pathPrefix.rest)) {
+        if (part.empty()) continue;
+        if (!node->isDirectory()) throw InvalidPathException(node->getName() + " is not a directory");
+
+        const Directory& dir{nodeCast<Directory>(*node)};
+        auto it = dir.children.find(part);
+        if (it == dir.children.end()) throw InvalidPathException(part);
+
+        node = it->second;
+        if (node->isSymlink()) node = followSymlink(nodeCast<Symlink>(*node), hops);
     }
 
     return node;
@@ -263,33 +984,35 @@ std::optional<std::vector<std::string>> FileSystemManager::grep(const std::strin
 {
     auto dstNode = navigateToDirectory(path, cwd);
     std::vector<std::string> res;
+    TraceSpan span{"traverse", "fs", path};
 
     if (!recursive) {
-        for (auto [name, child] : dstNode->children) {
-            if (!child->isDirectory()) {
-                auto fileNode = asNode<File>(child);
-                bool found{utility::KMPSolver::solve(fileNode->getContent(), pattern)};
+        for (const auto& [name, child] : dstNode->children) {
+            if (child->kind() == FileSystemNode::Kind::FILE) {
+                bool found{utility::KMPSolver::solve(nodeCast<File>(*child).getContent(), pattern)};
                 if (found) res.push_back(name);
             }
         }
     }
     else {
         std::vector<std::string> resPath;
-        dfsAndGrep(dstNode, pattern, resPath, res);
+        dfsAndGrep(*dstNode, pattern, resPath, res);
     }
 
     if (res.empty()) return std::nullopt;
     return res;
 }
 
-void FileSystemManager::dfsAndGrep(const std::shared_ptr<Directory>& node, const std::string& pattern, std::vector<std::string>& path, std::vector<std::string>& res) const
+void FileSystemManager::dfsAndGrep(const Directory& node, const std::string& pattern, std::vector<std::string>& path, std::vector<std::string>& res) const
 {
-    path.push_back(node->getName());
+    path.push_back(node.getName());
+
+    for (const auto& [name, child] : node.children) {
+        if (child->isSymlink()) continue;  // links are not followed, so a loop cannot trap the search
 
-    for (auto [name, child] : node->children) {
         if (!child->isDirectory()) {
-            auto fileNode = asNode<File>(child);
-            bool found{utility::KMPSolver::solve(fileNode->getContent(), pattern)};
+            const File& fileNode{nodeCast<File>(*child)};
+            bool found{utility::KMPSolver::solve(fileNode.getContent(), pattern)};
 
             if (found) {
                 std::string s;
@@ -298,13 +1021,12 @@ void FileSystemManager::dfsAndGrep(const std::shared_ptr<Directory>& node, const
                     s += path[i];
                 }
 
-                s += "/" + fileNode->getName();
+                s += "/" + fileNode.getName();
                 res.push_back(s);
             }
         }
         else {
-            auto dirNode = asNode<Directory>(child);
-            dfsAndGrep(dirNode, pattern, path, res);
+            dfsAndGrep(nodeCast<Directory>(*child), pattern, path, res);
         }
     }
 
@@ -314,24 +1036,162 @@ void FileSystemManager::dfsAndGrep(const std::shared_ptr<Directory>& node, const
 FileSystemManager::json FileSystemManager::convertToJson(const std::string& path) const
 {
     auto node = navigateToDirectory(path, cwd);
-    return directoryToJson(node);
+    TraceSpan span{"traverse", "fs", path};
+    return directoryToJson(*node);
 }
 
-FileSystemManager::json FileSystemManager::directoryToJson(std::shared_ptr<Directory> node) const
+FileSystemManager::json FileSystemManager::directoryToJson(const Directory& node) const
 {
     
     json j;
 
-    for (auto& [name, child] : node->children) {
+    for (const auto& [name, child] : node.children) {
+        if (child->isSymlink()) continue;  // a link has no content of its own
+
         if (child->isDirectory()) {
-            auto dirNode = asNode<Directory>(child);
-            j[name] = directoryToJson(dirNode);  // recursive
+            j[name] = directoryToJson(nodeCast<Directory>(*child));  // recursive
         }
         else {
-            auto fileNode = asNode<File>(child);
-            j[name] = fileNode->getContent();    // file content
+            j[name] = nodeCast<File>(*child).getContent();    // file content
         }
     }
 
     return j;
-}
\ No newline at end of file
+}
+
+FileSystemManager::ExportReport FileSystemManager::exportTree(const std::string& path, const std::string& hostPath) const
+{
+    auto node = findNode(path);
+    ExportReport report;
+
+    std::filesystem::path target{hostPath};
+    const std::string& name{node->getName()};
+    if (!name.empty() && std::filesystem::is_directory(target)) target /= name;
+
+    TraceSpan span{"export", "fs", path};
+    if (!node->isDirectory()) {
+        const std::string& content{nodeCast<File>(*node).getContent()};
+        writeHostFile(target, content);
+        return {1, 0, content.size()};
+    }
+
+    // Plan: every directory before its children, then the files in any order.
+    std::vector<std::pair<std::filesystem::path, const File*>> files;
+    std::vector<std::filesystem::path> openDirs{target};  // host path of the open directory at each depth
+    std::vector<std::filesystem::path> virtualDirs{std::filesystem::path{node->getFullPath()}};  // and its virtual path
+    std::error_code error;
+    if (!std::filesystem::create_directory(target, error) && error) throw std::system_error(error, "Cannot create " + target.string());
+    ++report.directories;
+
+    walk(path, std::numeric_limits<std::size_t>::max(), [&] (const std::string& childName, const FileSystemNode& child, std::size_t depth, bool) {
+        std::filesystem::path childPath{openDirs[depth - 1] / childName};
+        if (child.isDirectory()) {
+            if (!std::filesystem::create_directory(childPath, error) && error) throw std::system_error(error, "Cannot create " + childPath.string());
+            ++report.directories;
+            openDirs.resize(depth);
+            openDirs.push_back(std::move(childPath));
+            virtualDirs.resize(depth);
+            virtualDirs.push_back(virtualDirs.back() / childName);
+        }
+        else if (child.isSymlink()) {
+            const auto linkTarget = hostLinkTarget(virtualDirs.front(), virtualDirs[depth - 1], nodeCast<Symlink>(child).target());
+            if (!linkTarget) {
+                ++report.skippedSymlinks;
+                return;
+            }
+
+            std::filesystem::remove(childPath, error);  // replaces an existing host file, as for content
+            std::filesystem::create_symlink(*linkTarget, childPath, error);
+            if (error) throw std::system_error(error, "Cannot create " + childPath.string());
+            ++report.symlinks;
+        }
+        else {
+            const File& file{nodeCast<File>(child)};
+            report.bytes += file.getSize();
+            files.emplace_back(std::move(childPath), &file);
+        }
+    });
+    report.files = files.size();
+
+    // Workers claim files through a shared index; small exports stay on this thread.
+    constexpr std::size_t filesPerWorker{16};
+    const std::size_t workers{std::clamp<std::size_t>(files.size() / filesPerWorker, 1, std::max(1u, std::thread::hardware_concurrency()))};
+    std::atomic<std::size_t> next{0};
+    std::mutex failureMutex;
+    std::exception_ptr failure;
+
+    auto work = [&] {
+        for (std::size_t i{next++}; i < files.size(); i = next++) {
+            try {
+                writeHostFile(files[i].first, files[i].second->getContent());
+            }
+            catch (...) {
+                std::lock_guard lock{failureMutex};
+                if (!failure) failure = std::current_exception();
+                next = files.size();  // stop the other workers early
+            }
+        }
+    };
+
+    std::vector<std::jthread> pool;
+    for (std::size_t w{1}; w < workers; ++w) pool.emplace_back(work);
+    work();
+    pool.clear();  // joins
+
+    if (failure) std::rethrow_exception(failure);
+    return report;
+}
+
+std::vector<std::pair<std::string, Usage>> FileSystemManager::du(const std::string& path, bool summarize) const
+{
+    auto node = cwd;
+    if (!path.empty()) node = navigateToDirectory(path, node);
+
+    std::vector<std::pair<std::string, Usage>> res;
+    TraceSpan span{"traverse", "fs", path};
+    if (summarize) {
+        res.emplace_back(node->getFullPath(), node->getUsage());
+    }
+    else {
+        dfsAndDu(*node, node->getFullPath(), res);
+    }
+
+    return res;
+}
+
+void FileSystemManager::dfsAndDu(const Directory& node, const std::string& path, std::vector<std::pair<std::string, Usage>>& res) const
+{
+    const std::string prefix{path == "/" ? "" : path};
+
+    for (const auto& [name, child] : node.children) {
+        if (child->isDirectory()) {
+            dfsAndDu(nodeCast<Directory>(*child), prefix + "/" + name, res);
+        }
+    }
+
+    res.emplace_back(path, node.getUsage());
+}
+
+FileSystemManager::SpaceReport FileSystemManager::df() const
+{
+    // Rough per-node costs: the object itself (which holds the name and, for
+    // directories, the inline child slots) and the make_shared control block.
+    constexpr std::size_t controlBlock{2 * sizeof(long)};
+
+    // Upper bound per directory entry, as if every directory was promoted:
+    // an ordered map node (links and color, name view, shared_ptr) plus two index slots.
+    constexpr std::size_t mapEntry{4 * sizeof(void*) + sizeof(std::string_view) + sizeof(std::shared_ptr<FileSystemNode>) + 2 * sizeof(void*)};
+
+    SpaceReport report;
+    report.usage = root->getUsage();
+
+    // Links are counted as files; each file also owns (or shares, when hard-linked) a content body.
+    report.nodeOverhead = report.usage.files * (sizeof(File) + controlBlock + File::bodyOverhead())
+                        + report.usage.directories * (sizeof(Directory) + controlBlock);
+
+    // Names are stored once, in the nodes; directory indexes only hold views of them.
+    report.metadataOverhead = (report.usage.files + report.usage.directories) * mapEntry + report.usage.nameBytes;
+    report.metadataOverhead += MetadataStore::instance().memoryUsage();  // timestamps side table
+
+    return report;
+}
@@ -0,0 +1,131 @@
+#include "../include/GlobPattern.hpp"
+
+GlobPattern::GlobPattern(std::string_view pattern) : text{pattern}, recursive{pattern == "**"}
+{
+    for (std::size_t i{}; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            if (literal) prefix += text[++i];
+            else ++i;
+        }
+        else if (text[i] == '*' || text[i] == '?' || text[i] == '[') {
+            literal = false;
+        }
+        else if (literal) {
+            prefix += text[i];
+        }
+    }
+}
+
+bool GlobPattern::hasWildcard(std::string_view text) noexcept
+{
+    for (std::size_t i{}; i < text.size(); ++i) {
+        if (text[i] == '\\') ++i;
+        else if (text[i] == '*' || text[i] == '?' || text[i] == '[') return true;
+    }
+
+    return false;
+}
+
+std::string GlobPattern::unescape(std::string_view text)
+{
+    std::string res;
+    res.reserve(text.size());
+    for (std::size_t i{}; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) ++i;
+        res += text[i];
+    }
+
+    return res;
+}
+
+bool GlobPattern::matches(std::string_view name) const noexcept
+{
+    if (literal) return name == prefix;
+    if (name.substr(0, prefix.size()) != prefix) return false;
+
+    // Greedy scan with a single backtrack point at the last '*', linear for
+    // patterns without stars and O(n * m) at worst.
+    std::size_t p{}, n{};
+    std::size_t starP{std::string::npos}, starN{};
+
+    while (n < name.size()) {
+        if (p < text.size()) {
+            const char c{text[p]};
+            if (c == '*') {
+                starP = ++p;
+                starN = n;
+                continue;
+            }
+
+            if (c == '?') {
+                ++p; ++n;
+                continue;
+            }
+
+            if (c == '[') {
+                std::size_t q{p};
+                bool matched{};
+                if (matchBracket(q, name[n], matched)) {
+                    if (matched) {
+                        p = q; ++n;
+                        continue;
+                    }
+                }
+                else if (name[n] == '[') {
+                    ++p; ++n;
+                    continue;
+                }
+            }
+            else {
+                std::size_t q{p};
+                if (c == '\\' && q + 1 < text.size()) ++q;
+                if (text[q] == name[n]) {
+                    p = q + 1; ++n;
+                    continue;
+                }
+            }
+        }
+
+        if (starP == std::string::npos) return false;
+        p = starP;
+        n = ++starN;
+    }
+
+    while (p < text.size() && text[p] == '*') ++p;
+    return p == text.size();
+}
+
+bool GlobPattern::matchBracket(std::size_t& pos, char c, bool& matched) const noexcept
+{
+    std::size_t i{pos + 1};
+    bool negate{false};
+    if (i < text.size() && (text[i] == '!' || text[i] == '^')) {
+        negate = true;
+        ++i;
+    }
+
+    bool found{false};
+    bool first{true};
+    while (i < text.size() && (first || text[i] != ']')) {
+        first = false;
+
+        char lo{text[i]};
+        if (lo == '\\' && i + 1 < text.size()) lo = text[++i];
+        ++i;
+
+        char hi{lo};
+        if (i + 1 < text.size() && text[i] == '-' && text[i + 1] != ']') {
+            hi = text[i + 1];
+            if (hi == '\\' && i + 2 < text.size()) hi = text[++i + 1];
+            i += 2;
+        }
+
+        if (lo <= c && c <= hi) found = true;
+    }
+
+    if (i >= text.size()) return false;  // no closing ']'
+
+    pos = i + 1;
+    matched = found != negate;
+    return true;
+}
@@ -0,0 +1,241 @@
+#include "../include/History.hpp"
+#include "../include/FileSystemException.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+constexpr char magic[8]{'M', 'S', 'H', 'I', 'S', 'T', '0', '1'};
+constexpr std::size_t headerSize{16};  // magic and entry count at the start of the index
+constexpr std::size_t gramSize{3};
+constexpr unsigned gramBits{16};       // the search index has 2^gramBits buckets
+constexpr std::size_t blockSize{32};   // entries per block of the search index
+
+/// @brief Bucket of the trigram starting at gram.
+std::size_t gramBucket(const char* gram) noexcept
+{
+    const std::uint32_t key{static_cast<std::uint32_t>(static_cast<unsigned char>(gram[0])) << 16 |
+                            static_cast<std::uint32_t>(static_cast<unsigned char>(gram[1])) << 8 |
+                            static_cast<unsigned char>(gram[2])};
+    return (key * 0x9E3779B1u) >> (32 - gramBits);
+}
+
+void store(MappedFile& file, std::size_t position, std::uint64_t value) noexcept
+{
+    std::memcpy(file.data() + position, &value, sizeof(value));
+}
+
+} // namespace
+
+History& History::instance()
+{
+    static History history;
+    return history;
+}
+
+History::History() : lines{std::make_unique<MappedFile>()}, offsets{std::make_unique<MappedFile>()}
+{
+    rebuildIndex();
+}
+
+void History::open(const std::string& path)
+{
+    auto text = std::make_unique<MappedFile>(path);
+    auto index = std::make_unique<MappedFile>(path + ".idx");
+    lines = std::move(text);
+    offsets = std::move(index);
+    gramBlocks.clear();
+    indexed = 0;
+
+    bool valid{offsets->size() >= headerSize && std::memcmp(offsets->data(), magic, sizeof(magic)) == 0};
+    if (valid) {
+        const std::uint64_t entries{count()};
+        valid = entries <= (offsets->size() - headerSize) / sizeof(std::uint64_t);
+        if (valid && entries > 0) {
+            const std::uint64_t end{endOffset(entries - 1)};
+            valid = end > 0 && end <= lines->size() && lines->data()[end - 1] == '\n';
+        }
+    }
+
+    if (!valid) {
+        rebuildIndex();
+        return;
+    }
+
+    // Drops whatever follows the last complete entry, e.g. a line cut short by a crash.
+    const std::uint64_t entries{count()};
+    lines->resize(entries > 0 ? endOffset(entries - 1) : 0);
+    offsets->resize(headerSize + entries * sizeof(std::uint64_t));
+}
+
+void History::rebuildIndex()
+{
+    // The text ends at the first NUL: a file grown for a line that was never committed.
+    std::size_t size{lines->size()};
+    if (const void* nul{size > 0 ? std::memchr(lines->data(), '\0', size) : nullptr}) size = static_cast<std::size_t>(static_cast<const char*>(nul) - lines->data());
+    lines->resize(size);
+    if (size > 0 && lines->data()[size - 1] != '\n') {
+        lines->resize(size + 1);
+        lines->data()[size] = '\n';
+    }
+
+    offsets->resize(headerSize);
+    std::memcpy(offsets->data(), magic, sizeof(magic));
+
+    std::uint64_t entries{};
+    for (std::size_t pos{}; pos < lines->size(); ++entries) {
+        const char* newline{static_cast<const char*>(std::memchr(lines->data() + pos, '\n', lines->size() - pos))};
+        pos = static_cast<std::size_t>(newline - lines->data()) + 1;
+        offsets->resize(headerSize + (entries + 1) * sizeof(std::uint64_t));
+        store(*offsets, headerSize + entries * sizeof(std::uint64_t), pos);
+    }
+    store(*offsets, sizeof(magic), entries);
+}
+
+std::uint64_t History::count() const noexcept
+{
+    std::uint64_t res{};
+    std::memcpy(&res, offsets->data() + sizeof(magic), sizeof(res));
+    return res;
+}
+
+std::uint64_t History::endOffset(std::size_t index) const noexcept
+{
+    std::uint64_t res{};
+    std::memcpy(&res, offsets->data() + headerSize + index * sizeof(res), sizeof(res));
+    return res;
+}
+
+std::string_view History::entry(std::size_t index) const noexcept
+{
+    const std::size_t start{index > 0 ? static_cast<std::size_t>(endOffset(index - 1)) : 0};
+    const std::size_t end{static_cast<std::size_t>(endOffset(index)) - 1};
+    return {lines->data() + start, end - start};
+}
+
+void History::add(std::string_view line)
+{
+    if (line.find_first_of(std::string_view{"\n\0", 2}) != std::string_view::npos) return;
+
+    // The line first, then its offset, and only then the count that makes it an entry.
+    const std::size_t start{lines->size()};
+    lines->resize(start + line.size() + 1);
+    std::memcpy(lines->data() + start, line.data(), line.size());
+    lines->data()[start + line.size()] = '\n';
+
+    const std::uint64_t entries{count()};
+    offsets->resize(headerSize + (entries + 1) * sizeof(std::uint64_t));
+    store(*offsets, headerSize + entries * sizeof(std::uint64_t), lines->size());
+    store(*offsets, sizeof(magic), entries + 1);
+}
+
+void History::updateSearchIndex()
+{
+    if (gramBlocks.empty()) gramBlocks.resize(std::size_t{1} << gramBits);
+
+    for (const std::size_t entries{count()}; indexed < entries; ++indexed) {
+        const auto block = static_cast<std::uint32_t>(indexed / blockSize);
+        const std::string_view line{entry(indexed)};
+        for (std::size_t i{}; i + gramSize <= line.size(); ++i) {
+            auto& blocks = gramBlocks[gramBucket(line.data() + i)];
+            if (blocks.empty() || blocks.back() != block) blocks.push_back(block);
+        }
+    }
+}
+
+std::optional<std::size_t> History::search(std::string_view text, std::size_t before)
+{
+    before = std::min(before, static_cast<std::size_t>(count()));
+    if (text.empty()) return std::nullopt;
+
+    if (text.size() < gramSize) {
+        for (std::size_t i{before}; i-- > 0;) {
+            if (entry(i).find(text) != std::string_view::npos) return i;
+        }
+        return std::nullopt;
+    }
+
+    updateSearchIndex();
+
+    // A matching entry lies in a block listed for every trigram of the text;
+    // the shortest list drives, the others are probed.
+    std::vector<const std::vector<std::uint32_t>*> lists;
+    for (std::size_t i{}; i + gramSize <= text.size(); ++i) lists.push_back(&gramBlocks[gramBucket(text.data() + i)]);
+    std::sort(lists.begin(), lists.end(), [] (const auto* a, const auto* b) { return a->size() < b->size() || (a->size() == b->size() && a < b); });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    const std::vector<std::uint32_t>& driver{*lists.front()};
+    const auto limit = static_cast<std::uint32_t>((before + blockSize - 1) / blockSize);
+    for (auto it{std::lower_bound(driver.begin(), driver.end(), limit)}; it != driver.begin();) {
+        const std::uint32_t block{*--it};
+        const bool candidate{std::all_of(lists.begin() + 1, lists.end(), [block] (const auto* blocks) {
+            return std::binary_search(blocks->begin(), blocks->end(), block);
+        })};
+        if (!candidate) continue;
+
+        const std::size_t first{block * blockSize};
+        for (std::size_t i{std::min(before, first + blockSize)}; i-- > first;) {
+            if (entry(i).find(text) != std::string_view::npos) return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::string History::expand(const std::string& line) const
+{
+    const std::size_t entries{static_cast<std::size_t>(count())};
+    std::string res;
+    bool quoted{false};
+
+    for (std::size_t i{}; i < line.size(); ++i) {
+        const char c{line[i]};
+        if (c == '\'') {
+            quoted = !quoted;
+        }
+        else if (c == '\\' && !quoted && i + 1 < line.size()) {
+            res += c;
+            res += line[++i];
+            continue;
+        }
+
+        if (c != '!' || quoted || i + 1 == line.size() || std::string_view{" \t=(\"'"}.find(line[i + 1]) != std::string_view::npos) {
+            res += c;
+            continue;
+        }
+
+        std::size_t end{i + 1};
+        std::optional<std::size_t> event;
+        if (line[end] == '!') {
+            ++end;
+            if (entries > 0) event = entries - 1;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(line[end])) ||
+                 (line[end] == '-' && end + 1 < line.size() && std::isdigit(static_cast<unsigned char>(line[end + 1])))) {
+            const bool relative{line[end] == '-'};
+            std::size_t n{};
+            auto [next, ec] = std::from_chars(line.data() + end + relative, line.data() + line.size(), n);
+            end = static_cast<std::size_t>(next - line.data());
+            if (ec == std::errc{} && n >= 1 && n <= entries) event = relative ? entries - n : n - 1;
+        }
+        else {
+            end = std::min(line.find_first_of(" \t", end), line.size());
+            const std::string_view prefix{line.data() + i + 1, end - i - 1};
+            for (std::size_t e{entries}; e-- > 0;) {
+                if (entry(e).starts_with(prefix)) {
+                    event = e;
+                    break;
+                }
+            }
+        }
+
+        if (!event) throw InvalidOperationException(line.substr(i, end - i) + ": event not found");
+        res += entry(*event);
+        i = end - 1;
+    }
+
+    return res;
+}
@@ -0,0 +1,444 @@
+#include "../include/LineDiff.hpp"
+#include "../include/TextStats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace {
+
+/// @brief Block size for comparing the shared ends of two texts with memcmp.
+constexpr std::size_t compareBlock{4096};
+
+/// @brief Length of the longest common prefix of two byte ranges of at least @p size bytes.
+std::size_t commonPrefix(const char* a, const char* b, std::size_t size) noexcept
+{
+    std::size_t len{};
+    while (len + compareBlock <= size && std::memcmp(a + len, b + len, compareBlock) == 0) len += compareBlock;
+    while (len < size && a[len] == b[len]) ++len;
+    return len;
+}
+
+/// @brief Length of the longest common suffix, at most @p size bytes, of two ranges ending at @p aEnd and @p bEnd.
+std::size_t commonSuffix(const char* aEnd, const char* bEnd, std::size_t size) noexcept
+{
+    std::size_t len{};
+    while (len + compareBlock <= size && std::memcmp(aEnd - len - compareBlock, bEnd - len - compareBlock, compareBlock) == 0) {
+        len += compareBlock;
+    }
+    while (len < size && aEnd[-1 - static_cast<std::ptrdiff_t>(len)] == bEnd[-1 - static_cast<std::ptrdiff_t>(len)]) ++len;
+    return len;
+}
+
+/// @brief Moves a line start back by up to @p count lines.
+std::size_t linesBack(std::string_view text, std::size_t pos, std::size_t count) noexcept
+{
+    for (; count > 0 && pos > 0; --count) {
+        const std::size_t newline{pos < 2 ? std::string_view::npos : text.rfind('\n', pos - 2)};
+        pos = newline == std::string_view::npos ? 0 : newline + 1;
+    }
+    return pos;
+}
+
+/// @brief Moves a line start forward by up to @p count lines.
+std::size_t linesForward(std::string_view text, std::size_t pos, std::size_t count) noexcept
+{
+    for (; count > 0 && pos < text.size(); --count) {
+        const std::size_t newline{text.find('\n', pos)};
+        pos = newline == std::string_view::npos ? text.size() : newline + 1;
+    }
+    return pos;
+}
+
+/// @brief Splits a text into lines, each keeping its trailing newline.
+std::vector<std::string_view> splitLines(std::string_view text)
+{
+    std::vector<std::string_view> lines;
+    for (std::size_t pos{}; pos < text.size();) {
+        const std::size_t end{linesForward(text, pos, 1)};
+        lines.push_back(text.substr(pos, end - pos));
+        pos = end;
+    }
+    return lines;
+}
+
+/**
+ * @brief Gives equal lines equal ids, numbered from 0 in order of first appearance.
+ *
+ * An open-addressing table of (hash, id) pairs, half full at most, so a lookup
+ * is usually one probe and the whole table is a single allocation.
+ */
+class LineInterner
+{
+public:
+    explicit LineInterner(std::size_t lines) : slots(std::bit_ceil(2 * lines + 2)), mask{slots.size() - 1}
+    {
+        distinct.reserve(lines);
+    }
+
+    std::uint32_t intern(std::string_view line)
+    {
+        const std::size_t hash{std::hash<std::string_view>{}(line)};
+        const auto tag{static_cast<std::uint32_t>(hash >> 32)};
+        for (std::size_t i{hash & mask};; i = (i + 1) & mask) {
+            Slot& slot{slots[i]};
+            if (slot.id == 0) {
+                distinct.push_back(line);
+                slot = {tag, static_cast<std::uint32_t>(distinct.size())};
+                return slot.id - 1;
+            }
+            if (slot.tag == tag && distinct[slot.id - 1] == line) return slot.id - 1;
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::uint32_t tag;  ///< High bits of the hash, to skip most mismatches without comparing lines
+        std::uint32_t id;   ///< Id plus one, 0 for an empty slot
+    };
+
+    std::vector<Slot> slots;
+    const std::size_t mask;
+    std::vector<std::string_view> distinct;  ///< First line seen with each id
+};
+
+/// @brief Formats a line range of a hunk header: "start,count", or "start" for a single line.
+std::string hunkRange(std::size_t start, std::size_t count)
+{
+    // An empty range is given by the line before it.
+    std::string res{std::to_string(count == 0 ? start : start + 1)};
+    if (count != 1) res += ',' + std::to_string(count);
+    return res;
+}
+
+} // namespace
+
+LineDiff::LineDiff(std::string_view first, std::string_view second, std::size_t context) : context{context}
+{
+    // Leading bytes both texts share, cut back to the start of the line holding the first difference.
+    const std::size_t common{std::min(first.size(), second.size())};
+    const std::size_t prefix{commonPrefix(first.data(), second.data(), common)};
+    if (prefix == first.size() && prefix == second.size()) return;
+
+    const std::size_t lineStart{prefix == 0 ? 0 : first.rfind('\n', prefix - 1) + 1};  // npos + 1 == 0
+
+    // Trailing bytes both texts share, not overlapping the prefix, cut forward to a line start.
+    const std::size_t suffix{commonSuffix(first.data() + first.size(), second.data() + second.size(), common - lineStart)};
+    std::size_t lineEnd{first.size() - suffix};
+    if (lineEnd < first.size()) lineEnd = linesForward(first, lineEnd, 1);
+
+    // Only the differing lines and their context are split and compared.
+    const std::size_t begin{linesBack(first, lineStart, context)};
+    const std::size_t firstEnd{linesForward(first, lineEnd, context)};
+    const std::size_t secondEnd{second.size() - (first.size() - firstEnd)};
+
+    firstOffset = secondOffset = TextStats::count(first.substr(0, begin)).lines;
+    load(first.substr(begin, firstEnd - begin), second.substr(begin, secondEnd - begin));
+
+    compare(0, static_cast<std::ptrdiff_t>(firstIds.size()), 0, static_cast<std::ptrdiff_t>(secondIds.size()));
+
+    // Runs stay clear of the context lines around the differing region, so each keeps its full context.
+    // Those lines are equal in both texts and never marked, which makes them sentinels for the shifting.
+    const auto lineCount = [&] (std::size_t from, std::size_t to) {
+        return static_cast<std::ptrdiff_t>(std::count(first.begin() + static_cast<std::ptrdiff_t>(from), first.begin() + static_cast<std::ptrdiff_t>(to), '\n')
+                                           + (to > from && first[to - 1] != '\n'));
+    };
+    const std::ptrdiff_t before{lineCount(begin, lineStart)}, after{lineCount(lineEnd, firstEnd)};
+    const std::ptrdiff_t firstCore{static_cast<std::ptrdiff_t>(firstIds.size()) - before - after};
+    const std::ptrdiff_t secondCore{static_cast<std::ptrdiff_t>(secondIds.size()) - before - after};
+    shiftBoundaries(firstIds.data() + before, firstCore, firstChanged.data() + 1 + before, secondChanged.data() + 1 + before);
+    shiftBoundaries(secondIds.data() + before, secondCore, secondChanged.data() + 1 + before, firstChanged.data() + 1 + before);
+    collectChanges();
+
+    // Only the line views are needed for printing.
+    firstIds = {};
+    secondIds = {};
+    firstChanged = {};
+    secondChanged = {};
+    forward = {};
+    backward = {};
+}
+
+void LineDiff::load(std::string_view first, std::string_view second)
+{
+    firstLines = splitLines(first);
+    secondLines = splitLines(second);
+
+    // Equal lines get equal ids, so the search compares integers instead of strings.
+    LineInterner interner{firstLines.size() + secondLines.size()};
+    auto intern = [&] (const std::vector<std::string_view>& lines, std::vector<std::uint32_t>& out) {
+        out.reserve(lines.size());
+        for (std::string_view line : lines) out.push_back(interner.intern(line));
+    };
+    intern(firstLines, firstIds);
+    intern(secondLines, secondIds);
+
+    const std::size_t n{firstIds.size()}, m{secondIds.size()};
+    firstChanged.assign(n + 2, 0);
+    secondChanged.assign(m + 2, 0);
+
+    // Diagonals run from -m to n, plus a sentinel on each side.
+    forward.assign(n + m + 3, 0);
+    backward.assign(n + m + 3, 0);
+    diagonalOffset = static_cast<std::ptrdiff_t>(m) + 1;
+
+    // Past roughly sqrt(n + m) edits, a search gives up on a minimal result.
+    costLimit = 1;
+    for (std::size_t diagonals{n + m + 3}; diagonals != 0; diagonals >>= 2) costLimit <<= 1;
+    costLimit = std::max<std::ptrdiff_t>(costLimit, 4096);
+}
+
+void LineDiff::compare(std::ptrdiff_t first, std::ptrdiff_t firstEnd, std::ptrdiff_t second, std::ptrdiff_t secondEnd)
+{
+    for (;;) {
+        while (first < firstEnd && second < secondEnd && firstIds[first] == secondIds[second]) {
+            ++first;
+            ++second;
+        }
+        while (first < firstEnd && second < secondEnd && firstIds[firstEnd - 1] == secondIds[secondEnd - 1]) {
+            --firstEnd;
+            --secondEnd;
+        }
+
+        if (first == firstEnd) {
+            for (; second < secondEnd; ++second) secondChanged[second + 1] = 1;
+            return;
+        }
+        if (second == secondEnd) {
+            for (; first < firstEnd; ++first) firstChanged[first + 1] = 1;
+            return;
+        }
+
+        // Recurses into the smaller half and loops on the larger, so the stack stays logarithmic.
+        const auto [x, y] = split(first, firstEnd, second, secondEnd);
+        if ((x - first) + (y - second) < (firstEnd - x) + (secondEnd - y)) {
+            compare(first, x, second, y);
+            first = x;
+            second = y;
+        }
+        else {
+            compare(x, firstEnd, y, secondEnd);
+            firstEnd = x;
+            secondEnd = y;
+        }
+    }
+}
+
+std::pair<std::ptrdiff_t, std::ptrdiff_t> LineDiff::split(std::ptrdiff_t first, std::ptrdiff_t firstEnd,
+                                                          std::ptrdiff_t second, std::ptrdiff_t secondEnd)
+{
+    // x indexes the first text and y the second; diagonal d holds the points with x - y == d.
+    // The forward search starts at (first, second), the backward one at (firstEnd, secondEnd),
+    // and each step extends every reachable diagonal by one edit followed by a snake of equal lines.
+    const std::uint32_t* xv{firstIds.data()};
+    const std::uint32_t* yv{secondIds.data()};
+    std::ptrdiff_t* fd{forward.data() + diagonalOffset};
+    std::ptrdiff_t* bd{backward.data() + diagonalOffset};
+
+    const std::ptrdiff_t dmin{first - secondEnd}, dmax{firstEnd - second};
+    const std::ptrdiff_t fmid{first - second}, bmid{firstEnd - secondEnd};
+    std::ptrdiff_t fmin{fmid}, fmax{fmid}, bmin{bmid}, bmax{bmid};
+    const bool odd{((fmid - bmid) & 1) != 0};
+
+    fd[fmid] = first;
+    bd[bmid] = firstEnd;
+
+    for (std::ptrdiff_t cost{1};; ++cost) {
+        if (fmin > dmin) fd[--fmin - 1] = -1;
+        else ++fmin;
+        if (fmax < dmax) fd[++fmax + 1] = -1;
+        else --fmax;
+
+        for (std::ptrdiff_t d{fmax}; d >= fmin; d -= 2) {
+            const std::ptrdiff_t lo{fd[d - 1]}, hi{fd[d + 1]};
+            std::ptrdiff_t x{lo < hi ? hi : lo + 1};
+            std::ptrdiff_t y{x - d};
+            while (x < firstEnd && y < secondEnd && xv[x] == yv[y]) {
+                ++x;
+                ++y;
+            }
+            fd[d] = x;
+            if (odd && bmin <= d && d <= bmax && bd[d] <= x) return {x, y};
+        }
+
+        if (bmin > dmin) bd[--bmin - 1] = std::numeric_limits<std::ptrdiff_t>::max();
+        else ++bmin;
+        if (bmax < dmax) bd[++bmax + 1] = std::numeric_limits<std::ptrdiff_t>::max();
+        else --bmax;
+
+        for (std::ptrdiff_t d{bmax}; d >= bmin; d -= 2) {
+            const std::ptrdiff_t lo{bd[d - 1]}, hi{bd[d + 1]};
+            std::ptrdiff_t x{lo < hi ? lo : hi - 1};
+            std::ptrdiff_t y{x - d};
+            while (first < x && second < y && xv[x - 1] == yv[y - 1]) {
+                --x;
+                --y;
+            }
+            bd[d] = x;
+            if (!odd && fmin <= d && d <= fmax && x <= fd[d]) return {x, y};
+        }
+
+        if (cost < costLimit) continue;
+
+        // Too expensive: splits at whichever search got furthest from its corner.
+        std::ptrdiff_t forwardBest{-1}, forwardX{};
+        for (std::ptrdiff_t d{fmax}; d >= fmin; d -= 2) {
+            std::ptrdiff_t x{std::min(fd[d], firstEnd)};
+            std::ptrdiff_t y{x - d};
+            if (secondEnd < y) {
+                x = secondEnd + d;
+                y = secondEnd;
+            }
+            if (forwardBest < x + y) {
+                forwardBest = x + y;
+                forwardX = x;
+            }
+        }
+
+        std::ptrdiff_t backwardBest{std::numeric_limits<std::ptrdiff_t>::max()}, backwardX{};
+        for (std::ptrdiff_t d{bmax}; d >= bmin; d -= 2) {
+            std::ptrdiff_t x{std::max(first, bd[d])};
+            std::ptrdiff_t y{x - d};
+            if (y < second) {
+                x = second + d;
+                y = second;
+            }
+            if (x + y < backwardBest) {
+                backwardBest = x + y;
+                backwardX = x;
+            }
+        }
+
+        if ((firstEnd + secondEnd) - backwardBest < forwardBest - (first + second)) return {forwardX, forwardBest - forwardX};
+        return {backwardX, backwardBest - backwardX};
+    }
+}
+
+void LineDiff::shiftBoundaries(const std::uint32_t* ids, std::ptrdiff_t size, char* changed, const char* otherChanged) noexcept
+{
+    // Follows shift_boundaries of GNU diff. A run of changes can slide by one line
+    // whenever the line leaving it equals the line joining it; j tracks the
+    // matching position in the other text, whose runs stay put.
+    const std::ptrdiff_t end{size};
+    std::ptrdiff_t i{}, j{};
+
+    for (;;) {
+        while (i < end && !changed[i]) {
+            while (otherChanged[j++]) {}
+            ++i;
+        }
+        if (i == end) break;
+
+        std::ptrdiff_t start{i};
+        while (changed[++i]) {}
+        while (otherChanged[j]) ++j;
+
+        // i past the run's end where it last lined up with a run of the other text, or end if never.
+        std::ptrdiff_t corresponding;
+        std::ptrdiff_t runLength;
+        do {
+            runLength = i - start;
+
+            // Moves the run back while it can, merging it with earlier runs.
+            while (start > 0 && ids[start - 1] == ids[i - 1]) {
+                changed[--start] = 1;
+                changed[--i] = 0;
+                while (changed[start - 1]) --start;
+                while (otherChanged[--j]) {}
+            }
+
+            corresponding = otherChanged[j - 1] ? i : end;
+
+            // Then forward as far as possible, merging it with later runs.
+            while (i != end && ids[start] == ids[i]) {
+                changed[start++] = 0;
+                changed[i++] = 1;
+                while (changed[i]) ++i;
+                while (otherChanged[++j]) corresponding = i;
+            }
+        } while (runLength != i - start);
+
+        // Moves the merged run back to line up with a run of the other text, if it passed one.
+        while (corresponding < i) {
+            changed[--start] = 1;
+            changed[--i] = 0;
+            while (otherChanged[--j]) {}
+        }
+    }
+}
+
+void LineDiff::collectChanges()
+{
+    // Unchanged lines pair up one to one, so both texts are walked in step between changes.
+    const std::size_t n{firstChanged.size() - 2}, m{secondChanged.size() - 2};
+    const char* firstMarks{firstChanged.data() + 1};
+    const char* secondMarks{secondChanged.data() + 1};
+    std::size_t i{}, j{};
+    while (i < n || j < m) {
+        if ((i < n && firstMarks[i]) || (j < m && secondMarks[j])) {
+            Change change{i, 0, j, 0};
+            for (; i < n && firstMarks[i]; ++i) ++change.firstCount;
+            for (; j < m && secondMarks[j]; ++j) ++change.secondCount;
+            changes.push_back(change);
+            continue;
+        }
+        ++i;
+        ++j;
+    }
+}
+
+std::size_t LineDiff::hunkEnd(std::size_t begin) const noexcept
+{
+    // Changes whose context would overlap or touch share a hunk.
+    std::size_t last{begin};
+    while (last + 1 < changes.size() && changes[last + 1].first - (changes[last].first + changes[last].firstCount) <= 2 * context) {
+        ++last;
+    }
+    return last;
+}
+
+std::size_t LineDiff::hunkCount() const noexcept
+{
+    std::size_t count{};
+    for (std::size_t begin{}; begin < changes.size(); begin = hunkEnd(begin) + 1) ++count;
+    return count;
+}
+
+void LineDiff::writeUnified(const std::function<void(std::string_view)>& write) const
+{
+    auto writeLine = [&] (std::string_view marker, std::string_view line) {
+        write(marker);
+        write(line);
+        if (line.empty() || line.back() != '\n') write("\n\\ No newline at end of file\n");
+    };
+
+    for (std::size_t begin{}; begin < changes.size();) {
+        const std::size_t last{hunkEnd(begin)};
+        const Change& head{changes[begin]};
+        const Change& tail{changes[last]};
+
+        // Lines around the hunk are unchanged, so both texts have as many before and after it.
+        const std::size_t before{std::min(context, head.first)};
+        const std::size_t after{std::min(context, firstLines.size() - (tail.first + tail.firstCount))};
+        const std::size_t firstStart{head.first - before}, secondStart{head.second - before};
+        const std::size_t firstEnd{tail.first + tail.firstCount + after};
+        const std::size_t secondEnd{tail.second + tail.secondCount + after};
+
+        write("@@ -" + hunkRange(firstOffset + firstStart, firstEnd - firstStart)
+              + " +" + hunkRange(secondOffset + secondStart, secondEnd - secondStart) + " @@\n");
+
+        std::size_t i{firstStart};
+        for (std::size_t c{begin}; c <= last; ++c) {
+            const Change& change{changes[c]};
+            for (; i < change.first; ++i) writeLine(" ", firstLines[i]);
+            for (; i < change.first + change.firstCount; ++i) writeLine("-", firstLines[i]);
+            for (std::size_t j{change.second}; j < change.second + change.secondCount; ++j) writeLine("+", secondLines[j]);
+        }
+        for (; i < firstEnd; ++i) writeLine(" ", firstLines[i]);
+
+        begin = last + 1;
+    }
+}
@@ -0,0 +1,214 @@
+#include "../include/LineEditor.hpp"
+
+#include <iostream>
+
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+namespace {
+
+/// @brief Reads the rest of an escape sequence, e.g. of an arrow key, whose ESC was read.
+void skipEscapeSequence()
+{
+    char next{};
+    if (::read(STDIN_FILENO, &next, 1) == 1 && (next == '[' || next == 'O')) {
+        while (::read(STDIN_FILENO, &next, 1) == 1 && !(next >= 0x40 && next <= 0x7E)) { }
+    }
+}
+
+} // namespace
+#endif
+
+bool LineEditor::readLine(const std::string& prompt, std::string& line)
+{
+#ifndef _WIN32
+    if (interactive() && isatty(STDOUT_FILENO)) return readRaw(prompt, line);
+#endif
+
+    std::cout << prompt;
+    return static_cast<bool>(std::getline(std::cin, line));
+}
+
+bool LineEditor::interactive() noexcept
+{
+#ifndef _WIN32
+    return isatty(STDIN_FILENO);
+#else
+    return false;
+#endif
+}
+
+#ifndef _WIN32
+bool LineEditor::readRaw(const std::string& prompt, std::string& line)
+{
+    termios original{};
+    if (tcgetattr(STDIN_FILENO, &original) != 0) {
+        std::cout << prompt;
+        return static_cast<bool>(std::getline(std::cin, line));
+    }
+
+    // Raw only while a line is being edited, commands run with the terminal as usual.
+    termios raw{original};
+    raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO | ISIG);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+
+    struct Restore
+    {
+        const termios& mode;
+        ~Restore() { tcsetattr(STDIN_FILENO, TCSANOW, &mode); }
+    } restore{original};
+
+    line.clear();
+    std::cout << prompt << std::flush;
+
+    while (true) {
+        char c{};
+        if (::read(STDIN_FILENO, &c, 1) != 1) {
+            std::cout << std::endl;
+            return false;
+        }
+
+        switch (c) {
+        case '\r':
+        case '\n':
+            std::cout << std::endl;
+            return true;
+
+        case 4:  // Ctrl-D
+            if (line.empty()) {
+                std::cout << std::endl;
+                return false;
+            }
+            break;
+
+        case 3:  // Ctrl-C
+            line.clear();
+            std::cout << "^C\n" << prompt;
+            break;
+
+        case 8:
+        case 127:  // Backspace, removing a whole UTF-8 sequence
+            if (!line.empty()) {
+                while (line.size() > 1 && (static_cast<unsigned char>(line.back()) & 0xC0) == 0x80) line.pop_back();
+                line.pop_back();
+                std::cout << "\b \b";
+            }
+            break;
+
+        case '\t':
+            complete(prompt, line);
+            break;
+
+        case 18:  // Ctrl-R
+            if (searcher && reverseSearch(prompt, line)) {
+                std::cout << std::endl;
+                return true;
+            }
+            break;
+
+        case 27:  // escape sequence, e.g. arrow keys: skipped
+            skipEscapeSequence();
+            break;
+
+        default:
+            if (static_cast<unsigned char>(c) >= 32) {
+                line += c;
+                std::cout << c;
+            }
+            break;
+        }
+
+        std::cout << std::flush;
+    }
+}
+
+bool LineEditor::reverseSearch(const std::string& prompt, std::string& line)
+{
+    const std::string original{line};
+    std::string query;
+    std::optional<Match> match;
+    bool failed{false};
+    bool run{false};
+
+    // Searches before `before`; on failure the last match stays on display.
+    auto find = [&] (std::size_t before) {
+        std::optional<Match> found{searcher(query, before)};
+        failed = !found.has_value();
+        if (found) match = std::move(found);
+    };
+
+    while (true) {
+        std::cout << "\r\033[K(" << (failed ? "failed " : "") << "reverse-i-search)'" << query << "': "
+                  << (match ? match->line : std::string{}) << std::flush;
+
+        char c{};
+        if (::read(STDIN_FILENO, &c, 1) != 1) {
+            line = original;
+            break;
+        }
+
+        if (c == 18) {  // Ctrl-R: the next older match
+            if (match && !failed) find(match->position);
+        }
+        else if (c == 8 || c == 127) {
+            if (!query.empty()) {
+                query.pop_back();
+                match.reset();
+                failed = false;
+                if (!query.empty()) find(std::string::npos);
+            }
+        }
+        else if (c == 7 || c == 3) {  // Ctrl-G, Ctrl-C
+            line = original;
+            break;
+        }
+        else if (static_cast<unsigned char>(c) >= 32) {
+            query += c;
+            // The current match stays while it still contains the query.
+            find(match && !failed ? match->position + 1 : std::string::npos);
+        }
+        else {
+            if (c == 27) skipEscapeSequence();
+            if (match) line = match->line;
+            run = c == '\r' || c == '\n';
+            break;
+        }
+    }
+
+    std::cout << "\r\033[K" << prompt << line << std::flush;
+    return run;
+}
+#else
+bool LineEditor::readRaw(const std::string& prompt, std::string& line)
+{
+    std::cout << prompt;
+    return static_cast<bool>(std::getline(std::cin, line));
+}
+
+bool LineEditor::reverseSearch([[maybe_unused]] const std::string& prompt, [[maybe_unused]] std::string& line)
+{
+    return false;
+}
+#endif
+
+void LineEditor::complete(const std::string& prompt, std::string& line)
+{
+    Completion completion{completer(line)};
+
+    if (!completion.insertion.empty()) {
+        line += completion.insertion;
+        std::cout << completion.insertion;
+        return;
+    }
+
+    if (completion.candidates.size() > 1) {
+        std::cout << "\n";
+        for (const std::string& candidate : completion.candidates) std::cout << candidate << "  ";
+        std::cout << "\n" << prompt << line;
+    }
+}
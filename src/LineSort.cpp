@@ -0,0 +1,213 @@
+#include "../include/LineSort.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+/// @brief Fewest lines per sorting thread; smaller inputs are sorted on the calling thread.
+constexpr std::size_t linesPerWorker{1 << 15};
+
+std::vector<std::string_view> splitLines(std::string_view text)
+{
+    std::vector<std::string_view> lines;
+    const char* data{text.data()};
+    std::size_t start{};
+    while (start < text.size()) {
+        const void* newline{std::memchr(data + start, '\n', text.size() - start)};
+        const std::size_t end{newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - data) : text.size()};
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return lines;
+}
+
+/**
+ * @brief A line with its first 8 bytes packed big-endian, zero-padded.
+ *
+ * Most comparisons are decided by the integer alone, so the sort seldom
+ * follows the view into the text and misses the cache.
+ */
+struct PrefixedLine
+{
+    PrefixedLine() = default;
+
+    explicit PrefixedLine(std::string_view text) : line{text}
+    {
+        const std::size_t size{std::min<std::size_t>(text.size(), 8)};
+        for (std::size_t i{}; i < size; ++i) prefix |= std::uint64_t{static_cast<unsigned char>(text[i])} << (56 - 8 * i);
+    }
+
+    std::uint64_t prefix{};
+    std::string_view line;
+};
+
+constexpr bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+/// @brief A line with its leading number, split so that numbers of any length compare exactly.
+struct NumericLine
+{
+    NumericLine() = default;
+
+    explicit NumericLine(std::string_view text) : line{text}
+    {
+        std::size_t i{};
+        while (i < text.size() && (text[i] == ' ' || text[i] == '\t')) ++i;
+        const bool minus{i < text.size() && text[i] == '-'};
+        if (minus) ++i;
+
+        std::size_t begin{i};
+        while (i < text.size() && isDigit(text[i])) ++i;
+        integer = text.substr(begin, i - begin);
+        while (!integer.empty() && integer.front() == '0') integer.remove_prefix(1);
+
+        if (i < text.size() && text[i] == '.') {
+            begin = ++i;
+            while (i < text.size() && isDigit(text[i])) ++i;
+            fraction = text.substr(begin, i - begin);
+            while (!fraction.empty() && fraction.back() == '0') fraction.remove_suffix(1);
+        }
+
+        negative = minus && !(integer.empty() && fraction.empty());
+    }
+
+    std::string_view line;
+    std::string_view integer;   ///< Integer digits without leading zeros
+    std::string_view fraction;  ///< Fraction digits without trailing zeros
+    bool negative{};            ///< Set only for a non-zero number
+};
+
+int compareKeys(const PrefixedLine& a, const PrefixedLine& b) noexcept
+{
+    // Padding sorts below every byte, so unequal prefixes order the lines; "a" and "a\0" need the full compare.
+    if (a.prefix != b.prefix) return a.prefix < b.prefix ? -1 : 1;
+    return a.line.compare(b.line);
+}
+
+int compareKeys(const NumericLine& a, const NumericLine& b) noexcept
+{
+    if (a.negative != b.negative) return a.negative ? -1 : 1;
+
+    // Without leading zeros, the longer integer part is the larger number.
+    int order{};
+    if (a.integer.size() != b.integer.size()) order = a.integer.size() < b.integer.size() ? -1 : 1;
+    else if ((order = a.integer.compare(b.integer)) == 0) order = a.fraction.compare(b.fraction);
+
+    order = (order > 0) - (order < 0);
+    return a.negative ? -order : order;
+}
+
+std::string_view lineOf(const PrefixedLine& line) noexcept { return line.line; }
+std::string_view lineOf(const NumericLine& line) noexcept { return line.line; }
+
+/**
+ * @brief Number of items taken from @p a among the first @p k outputs of a stable merge of a and b.
+ *
+ * Binary search on the split point: items of a precede equal items of b.
+ */
+template <typename T, typename Less>
+std::size_t coRank(std::size_t k, const T* a, std::size_t aSize, const T* b, std::size_t bSize, const Less& less)
+{
+    std::size_t lo{k > bSize ? k - bSize : 0};
+    std::size_t hi{std::min(k, aSize)};
+    while (lo < hi) {
+        const std::size_t i{lo + (hi - lo) / 2};
+        if (!less(b[k - i - 1], a[i])) lo = i + 1;  // a[i] is output before b[k - i - 1]
+        else hi = i;
+    }
+    return lo;
+}
+
+/// @brief Stable merge sort, run on several threads when the input is large enough.
+template <typename T, typename Less>
+void parallelSort(std::vector<T>& items, const Less& less)
+{
+    const std::size_t size{items.size()};
+    const std::size_t workers{std::clamp<std::size_t>(size / linesPerWorker, 1, std::max(1u, std::thread::hardware_concurrency()))};
+    if (workers == 1) {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    // Runs task(t) for every thread index t, the calling thread taking t = 0.
+    auto runInParallel = [workers] (const auto& task) {
+        std::vector<std::jthread> pool;
+        for (std::size_t t{1}; t < workers; ++t) pool.emplace_back([&task, t] { task(t); });
+        task(0);
+    };
+
+    // One run per thread; run r is [runs[r], runs[r + 1]).
+    std::vector<std::size_t> runs(workers + 1);
+    for (std::size_t r{}; r <= workers; ++r) runs[r] = size * r / workers;
+    runInParallel([&] (std::size_t r) { std::stable_sort(items.begin() + runs[r], items.begin() + runs[r + 1], less); });
+
+    std::vector<T> buffer(size);
+    T* from{items.data()};
+    T* to{buffer.data()};
+    for (std::size_t width{1}; width < workers; width *= 2) {
+        // Merges groups of 2 * width runs pairwise; thread t writes the t-th slice of the
+        // output, whichever merges it overlaps, starting each at its co-ranked inputs.
+        runInParallel([&] (std::size_t t) {
+            std::size_t pos{size * t / workers};
+            const std::size_t sliceEnd{size * (t + 1) / workers};
+            std::size_t group{};
+            while (pos < sliceEnd) {
+                while (runs[std::min(group + 2 * width, workers)] <= pos) group += 2 * width;
+
+                const std::size_t begin{runs[group]};
+                const std::size_t mid{runs[std::min(group + width, workers)]};
+                const std::size_t end{runs[std::min(group + 2 * width, workers)]};
+                const std::size_t stop{std::min(sliceEnd, end)};
+
+                const T* a{from + begin};
+                const T* b{from + mid};
+                const std::size_t i0{coRank(pos - begin, a, mid - begin, b, end - mid, less)};
+                const std::size_t i1{coRank(stop - begin, a, mid - begin, b, end - mid, less)};
+                std::merge(a + i0, a + i1, b + (pos - begin - i0), b + (stop - begin - i1), to + pos, less);
+                pos = stop;
+            }
+        });
+        std::swap(from, to);
+    }
+
+    if (from != items.data()) items.swap(buffer);
+}
+
+template <typename T>
+void sortItems(std::vector<T>& items, const SortOptions& options)
+{
+    // Equal keys fall back to the bytes of the whole line, unless they are to be merged.
+    auto less = [&options] (const T& a, const T& b) {
+        int order{compareKeys(a, b)};
+        if (order == 0 && !options.unique) order = lineOf(a).compare(lineOf(b));
+        return options.reverse ? order > 0 : order < 0;
+    };
+    parallelSort(items, less);
+
+    // The sort is stable, so each run of equal keys starts with its first line in the text.
+    if (options.unique) {
+        items.erase(std::unique(items.begin(), items.end(), [] (const T& a, const T& b) { return compareKeys(a, b) == 0; }), items.end());
+    }
+}
+
+} // namespace
+
+std::vector<std::string_view> sortLines(std::string_view text, const SortOptions& options)
+{
+    std::vector<std::string_view> lines{splitLines(text)};
+    auto sortBy = [&] <typename T> () {
+        std::vector<T> keyed;
+        keyed.reserve(lines.size());
+        for (std::string_view line : lines) keyed.emplace_back(line);
+        sortItems(keyed, options);
+
+        lines.resize(keyed.size());
+        for (std::size_t i{}; i < keyed.size(); ++i) lines[i] = lineOf(keyed[i]);
+    };
+
+    if (options.numeric) sortBy.template operator()<NumericLine>();
+    else sortBy.template operator()<PrefixedLine>();
+    return lines;
+}
@@ -0,0 +1,110 @@
+#include "../include/MappedFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::size_t minCapacity{64 * 1024};
+
+} // namespace
+
+#ifndef _WIN32
+MappedFile::MappedFile(const std::string& path)
+{
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+
+    if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        ::close(fd);
+        fd = -1;
+        throw std::runtime_error(path + " is in use by another process");
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        fd = -1;
+        throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(errno));
+    }
+
+    try {
+        map(static_cast<std::size_t>(info.st_size));
+    }
+    catch (...) {
+        ::close(fd);
+        fd = -1;
+        throw;
+    }
+    length = capacity;
+}
+
+MappedFile::~MappedFile()
+{
+    if (fd < 0) return;
+
+    if (bytes != nullptr) ::munmap(bytes, capacity);
+    [[maybe_unused]] const int res{::ftruncate(fd, static_cast<off_t>(length))};
+    ::close(fd);
+}
+
+void MappedFile::map(std::size_t size)
+{
+    if (bytes != nullptr) ::munmap(bytes, capacity);
+    bytes = nullptr;
+    capacity = 0;
+    if (size == 0) return;
+
+    void* address{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+    if (address == MAP_FAILED) throw std::runtime_error(std::string{"Cannot map file: "} + std::strerror(errno));
+
+    bytes = static_cast<char*>(address);
+    capacity = size;
+}
+
+void MappedFile::resize(std::size_t size)
+{
+    if (size > capacity) {
+        const std::size_t grown{std::max({size, capacity * 2, minCapacity})};
+        if (fd >= 0) {
+            if (::ftruncate(fd, static_cast<off_t>(grown)) != 0) throw std::runtime_error(std::string{"Cannot extend file: "} + std::strerror(errno));
+            map(grown);
+        }
+        else {
+            memory.resize(grown);
+            bytes = memory.data();
+            capacity = grown;
+        }
+    }
+
+    length = size;
+}
+#else
+MappedFile::MappedFile(const std::string& path)
+{
+    throw std::runtime_error("Cannot map " + path + ": memory-mapped files are not supported");
+}
+
+MappedFile::~MappedFile() = default;
+
+void MappedFile::resize(std::size_t size)
+{
+    if (size > capacity) {
+        capacity = std::max({size, capacity * 2, minCapacity});
+        memory.resize(capacity);
+        bytes = memory.data();
+    }
+
+    length = size;
+}
+#endif
@@ -0,0 +1,275 @@
+#include "../include/MetricsRegistry.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <unordered_map>
+
+// ---------------- LatencyHistogram ----------------
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value) noexcept
+{
+    if (value < subBuckets) return static_cast<std::size_t>(value);
+
+    std::size_t shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - subBucketBits;
+    std::size_t sub = static_cast<std::size_t>(value >> shift) & (subBuckets - 1);
+    return (shift + 1) * subBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index) noexcept
+{
+    if (index < subBuckets) return index;
+
+    std::size_t shift = index / subBuckets - 1;
+    std::uint64_t sub = index % subBuckets;
+    std::uint64_t lower = (subBuckets + sub) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+void LatencyHistogram::record(std::uint64_t value) noexcept
+{
+    ++counts[bucketIndex(value)];
+    addTotals(1, value, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+{
+    for (std::size_t i{}; i < bucketCount; ++i) counts[i] += other.counts[i];
+    addTotals(other.total, other.totalSum, other.maxValue);
+}
+
+void LatencyHistogram::addTotals(std::uint64_t samples, std::uint64_t sum, std::uint64_t max) noexcept
+{
+    total += samples;
+    totalSum += sum;
+    maxValue = std::max(maxValue, max);
+}
+
+std::uint64_t LatencyHistogram::quantile(double q) const noexcept
+{
+    if (total == 0) return 0;
+
+    auto rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total)));
+    rank = std::clamp<std::uint64_t>(rank, 1, total);
+
+    std::uint64_t seen{};
+    for (std::size_t i{}; i < bucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(bucketUpperBound(i), maxValue);
+    }
+
+    return maxValue;
+}
+
+// ---------------- MetricsRegistry ----------------
+
+/// Metrics of one command within one shard. Only the owning thread writes.
+struct MetricsRegistry::Series
+{
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> max{0};
+    std::array<std::atomic<std::uint64_t>, LatencyHistogram::bucketCount> buckets{};
+    std::array<std::atomic<std::uint64_t>, maxErrorKinds> errors{};
+};
+
+/// Per-thread recording area. Series are allocated lazily by the owner and published with release.
+struct MetricsRegistry::Shard
+{
+    std::array<std::atomic<Series*>, maxSeries> series{};
+    std::vector<std::unique_ptr<Series>> storage;
+
+    /// Owner-only caches in front of the interned name tables.
+    std::unordered_map<std::string, std::size_t> seriesIds;
+    std::unordered_map<const char*, std::size_t> errorKindIds;
+};
+
+namespace {
+
+/// Single-writer increment: cheaper than fetch_add and still safe for concurrent readers.
+inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+std::string escapeLabel(const std::string& value)
+{
+    std::string res;
+    for (char c : value) {
+        if (c == '\\' || c == '"') res += '\\';
+        if (c == '\n') { res += "\\n"; continue; }
+        res += c;
+    }
+
+    return res;
+}
+
+} // namespace
+
+std::uint64_t MetricsRegistry::CommandStats::errorCount() const noexcept
+{
+    std::uint64_t res{};
+    for (const auto& [_, n] : errors) res += n;
+    return res;
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Shard& MetricsRegistry::localShard()
+{
+    thread_local Shard* shard{nullptr};
+    if (shard == nullptr) {
+        std::lock_guard lock{mutex};
+        shards.push_back(std::make_unique<Shard>());
+        shard = shards.back().get();
+    }
+
+    return *shard;
+}
+
+std::size_t MetricsRegistry::intern(std::vector<std::string>& table, std::size_t limit, const std::string& name)
+{
+    std::lock_guard lock{mutex};
+
+    auto it = std::find(table.begin(), table.end(), name);
+    if (it != table.end()) return static_cast<std::size_t>(it - table.begin());
+
+    // The last slot is reserved for everything past the limit.
+    if (table.size() + 1 >= limit) {
+        if (table.size() + 1 == limit) table.push_back("other");
+        return limit - 1;
+    }
+
+    table.push_back(name);
+    return table.size() - 1;
+}
+
+void MetricsRegistry::record(const std::string& command, std::uint64_t latencyNs, const char* errorKind)
+{
+    Shard& shard = localShard();
+
+    auto idIt = shard.seriesIds.find(command);
+    if (idIt == shard.seriesIds.end()) {
+        idIt = shard.seriesIds.emplace(command, intern(seriesNames, maxSeries, command)).first;
+    }
+
+    Series* series = shard.series[idIt->second].load(std::memory_order_relaxed);
+    if (series == nullptr) {
+        shard.storage.push_back(std::make_unique<Series>());
+        series = shard.storage.back().get();
+        shard.series[idIt->second].store(series, std::memory_order_release);
+    }
+
+    bump(series->count, 1);
+    bump(series->sum, latencyNs);
+    bump(series->buckets[LatencyHistogram::bucketIndex(latencyNs)], 1);
+    if (latencyNs > series->max.load(std::memory_order_relaxed)) {
+        series->max.store(latencyNs, std::memory_order_relaxed);
+    }
+
+    if (errorKind != nullptr) {
+        auto kindIt = shard.errorKindIds.find(errorKind);
+        if (kindIt == shard.errorKindIds.end()) {
+            kindIt = shard.errorKindIds.emplace(errorKind, intern(errorKindNames, maxErrorKinds, errorKind)).first;
+        }
+
+        bump(series->errors[kindIt->second], 1);
+    }
+}
+
+std::vector<MetricsRegistry::CommandStats> MetricsRegistry::snapshot() const
+{
+    std::lock_guard lock{mutex};
+
+    std::vector<CommandStats> res(seriesNames.size());
+    std::vector<std::vector<std::uint64_t>> errors(seriesNames.size(), std::vector<std::uint64_t>(errorKindNames.size()));
+
+    for (const auto& shard : shards) {
+        for (std::size_t id{}; id < seriesNames.size(); ++id) {
+            const Series* series = shard->series[id].load(std::memory_order_acquire);
+            if (series == nullptr) continue;
+
+            auto& stats = res[id];
+            std::uint64_t count = series->count.load(std::memory_order_relaxed);
+            stats.count += count;
+            stats.latency.addTotals(count, series->sum.load(std::memory_order_relaxed), series->max.load(std::memory_order_relaxed));
+
+            for (std::size_t b{}; b < LatencyHistogram::bucketCount; ++b) {
+                std::uint64_t n = series->buckets[b].load(std::memory_order_relaxed);
+                if (n > 0) stats.latency.addBucket(b, n);
+            }
+
+            for (std::size_t k{}; k < errorKindNames.size(); ++k) {
+                errors[id][k] += series->errors[k].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (std::size_t id{}; id < seriesNames.size(); ++id) {
+        res[id].name = seriesNames[id];
+        for (std::size_t k{}; k < errorKindNames.size(); ++k) {
+            if (errors[id][k] > 0) res[id].errors.emplace_back(errorKindNames[k], errors[id][k]);
+        }
+    }
+
+    std::sort(res.begin(), res.end(), [] (const CommandStats& a, const CommandStats& b) { return a.name < b.name; });
+    return res;
+}
+
+void MetricsRegistry::writePrometheus(std::ostream& out) const
+{
+    const auto stats = snapshot();
+    constexpr double nsPerSecond{1e9};
+    constexpr unsigned firstBoundBits{10};  // histogram bounds written are 2^bits - 1 nanoseconds
+    constexpr unsigned lastBoundBits{36};
+
+    out << "# HELP minishell_commands_total Total number of executed commands.\n"
+        << "# TYPE minishell_commands_total counter\n";
+    for (const auto& s : stats) {
+        out << "minishell_commands_total{command=\"" << escapeLabel(s.name) << "\"} " << s.count << "\n";
+    }
+
+    out << "# HELP minishell_command_errors_total Failed commands by exception kind.\n"
+        << "# TYPE minishell_command_errors_total counter\n";
+    for (const auto& s : stats) {
+        for (const auto& [kind, n] : s.errors) {
+            out << "minishell_command_errors_total{command=\"" << escapeLabel(s.name)
+                << "\",kind=\"" << escapeLabel(kind) << "\"} " << n << "\n";
+        }
+    }
+
+    out << "# HELP minishell_command_duration_seconds Command execution latency.\n"
+        << "# TYPE minishell_command_duration_seconds histogram\n";
+    for (const auto& s : stats) {
+        const std::string label = "command=\"" + escapeLabel(s.name) + "\"";
+        const auto& buckets = s.latency.buckets();
+
+        // The same bounds on every scrape, as Prometheus expects: one per power of two of
+        // nanoseconds from about 1us to 69s. Each is the upper edge of a histogram bucket,
+        // so the cumulative counts are exact.
+        std::uint64_t cumulative{};
+        std::size_t i{};
+        for (unsigned bits{firstBoundBits}; bits <= lastBoundBits; ++bits) {
+            const std::uint64_t bound{(std::uint64_t{1} << bits) - 1};
+            for (; i < buckets.size() && LatencyHistogram::bucketUpperBound(i) <= bound; ++i) cumulative += buckets[i];
+            out << "minishell_command_duration_seconds_bucket{" << label << ",le=\""
+                << static_cast<double>(bound) / nsPerSecond << "\"} " << cumulative << "\n";
+        }
+
+        out << "minishell_command_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << s.latency.count() << "\n"
+            << "minishell_command_duration_seconds_sum{" << label << "} " << static_cast<double>(s.latency.sum()) / nsPerSecond << "\n"
+            << "minishell_command_duration_seconds_count{" << label << "} " << s.latency.count() << "\n";
+    }
+
+    out << "# HELP minishell_command_duration_quantile_seconds Latency quantiles estimated from the histogram.\n"
+        << "# TYPE minishell_command_duration_quantile_seconds gauge\n";
+    for (const auto& s : stats) {
+        for (const char* q : {"0.5", "0.99", "0.999"}) {
+            out << "minishell_command_duration_quantile_seconds{command=\"" << escapeLabel(s.name) << "\",quantile=\"" << q << "\"} "
+                << static_cast<double>(s.latency.quantile(std::stod(q))) / nsPerSecond << "\n";
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#include "../include/NodeMetadata.hpp"
+
+// ---------------- CoarseClock ----------------
+CoarseClock::time_point CoarseClock::now() noexcept
+{
+    std::int64_t ticks = cached.load(std::memory_order_relaxed);
+    if (ticks == 0) {
+        tick();
+        ticks = cached.load(std::memory_order_relaxed);
+    }
+
+    return time_point{time_point::duration{ticks}};
+}
+
+void CoarseClock::tick() noexcept
+{
+    cached.store(std::chrono::system_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+// ---------------- MetadataStore ----------------
+MetadataStore& MetadataStore::instance()
+{
+    // Never destroyed: nodes owned by other statics may still unregister at exit.
+    static MetadataStore* store = new MetadataStore;
+    return *store;
+}
+
+std::size_t MetadataStore::home(const FileSystemNode* node) const noexcept
+{
+    // Fibonacci hashing spreads the aligned addresses over the table.
+    const auto bits = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(node));
+    return static_cast<std::size_t>((bits * 0x9E3779B97F4A7C15ull) >> 32) & (slots.size() - 1);
+}
+
+std::size_t MetadataStore::probe(const FileSystemNode* node) const noexcept
+{
+    std::size_t i{home(node)};
+    while (slots[i].key && slots[i].key != node) i = (i + 1) & (slots.size() - 1);
+    return i;
+}
+
+void MetadataStore::grow()
+{
+    std::vector<Slot> old(slots.empty() ? 64 : slots.size() * 2);
+    old.swap(slots);
+
+    for (const Slot& slot : old) {
+        if (slot.key) slots[probe(slot.key)] = slot;
+    }
+}
+
+void MetadataStore::onCreate(const FileSystemNode* node)
+{
+    if (2 * (used + 1) > slots.size()) grow();
+
+    Slot& slot = slots[probe(node)];
+    if (!slot.key) ++used;
+
+    const auto now = CoarseClock::now();
+    slot = {node, {now, now}};
+}
+
+void MetadataStore::onModify(const FileSystemNode* node)
+{
+    if (slots.empty()) return;
+
+    Slot& slot = slots[probe(node)];
+    if (slot.key) slot.metadata.modified = CoarseClock::now();
+}
+
+void MetadataStore::onDestroy(const FileSystemNode* node) noexcept
+{
+    if (slots.empty()) return;
+
+    const std::size_t mask{slots.size() - 1};
+    std::size_t hole{probe(node)};
+    if (!slots[hole].key) return;
+
+    // Backward-shift deletion: pull later entries of the cluster into the hole
+    // unless that would move them before their home slot.
+    for (std::size_t i{(hole + 1) & mask}; slots[i].key; i = (i + 1) & mask) {
+        const std::size_t h{home(slots[i].key)};
+        if (((i - h) & mask) >= ((i - hole) & mask)) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+
+    slots[hole] = Slot{};
+    --used;
+}
+
+NodeMetadata MetadataStore::get(const FileSystemNode* node) const
+{
+    if (slots.empty()) return {};
+
+    const Slot& slot = slots[probe(node)];
+    return slot.key ? slot.metadata : NodeMetadata{};
+}
@@ -0,0 +1,77 @@
+#include "../include/PieceTable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+PieceTable::PieceTable(std::string_view original) : original{original}, totalSize{original.size()}
+{
+    if (!original.empty()) pieces.push_back({false, 0, original.size()});
+}
+
+void PieceTable::seek(std::size_t offset) noexcept
+{
+    while (cursorPiece > 0 && cursorOffset > offset) {
+        --cursorPiece;
+        cursorOffset -= pieces[cursorPiece].length;
+    }
+    while (cursorPiece < pieces.size() && cursorOffset + pieces[cursorPiece].length <= offset) {
+        cursorOffset += pieces[cursorPiece].length;
+        ++cursorPiece;
+    }
+}
+
+void PieceTable::replace(std::size_t offset, std::size_t length, std::string_view text)
+{
+    if (offset > totalSize || length > totalSize - offset) throw std::out_of_range("PieceTable::replace");
+    if (length == 0 && text.empty()) return;
+
+    seek(offset);
+    const std::size_t first{cursorPiece};
+    const std::size_t within{offset - cursorOffset};
+
+    // Up to three pieces take the place of the affected ones: what precedes the
+    // range in the first piece, the new bytes, and what follows it in the last.
+    std::array<Piece, 3> replacement;
+    std::size_t count{};
+    if (within > 0) replacement[count++] = {pieces[first].added, pieces[first].offset, within};
+    if (!text.empty()) {
+        replacement[count++] = {true, added.size(), text.size()};
+        added += text;
+    }
+
+    std::size_t last{first};
+    std::size_t skip{within + length};  // bytes dropped from the start of piece last
+    while (last < pieces.size() && skip >= pieces[last].length) skip -= pieces[last++].length;
+    if (last < pieces.size() && skip > 0) {
+        replacement[count++] = {pieces[last].added, pieces[last].offset + skip, pieces[last].length - skip};
+        ++last;
+    }
+
+    const std::size_t removed{last - first};
+    if (count > removed) pieces.insert(pieces.begin() + static_cast<std::ptrdiff_t>(first), count - removed, Piece{});
+    else pieces.erase(pieces.begin() + static_cast<std::ptrdiff_t>(first), pieces.begin() + static_cast<std::ptrdiff_t>(first + removed - count));
+    std::copy_n(replacement.begin(), count, pieces.begin() + static_cast<std::ptrdiff_t>(first));
+
+    totalSize = totalSize - length + text.size();
+    cursorPiece = first + (within > 0) + !text.empty();
+    cursorOffset = offset + text.size();
+}
+
+std::string_view PieceTable::view(const Piece& piece) const noexcept
+{
+    return (piece.added ? std::string_view{added} : original).substr(piece.offset, piece.length);
+}
+
+void PieceTable::forEachPiece(const std::function<void(std::string_view)>& visit) const
+{
+    for (const Piece& piece : pieces) visit(view(piece));
+}
+
+std::string PieceTable::toString() const
+{
+    std::string res;
+    res.reserve(totalSize);
+    for (const Piece& piece : pieces) res += view(piece);
+    return res;
+}
@@ -0,0 +1,43 @@
+#include "../include/SessionRecorder.hpp"
+#include "../include/FileSystemException.hpp"
+
+SessionRecorder& SessionRecorder::instance()
+{
+    static SessionRecorder recorder;
+    return recorder;
+}
+
+void SessionRecorder::start(const std::string& file)
+{
+    std::lock_guard lock{mutex};
+    if (enabled()) throw InvalidOperationException("Already recording");
+
+    out.open(file, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + file);
+    }
+
+    out << "# minishell session\n";
+    startTime = std::chrono::steady_clock::now();
+    active.store(true, std::memory_order_relaxed);
+}
+
+void SessionRecorder::stop()
+{
+    std::lock_guard lock{mutex};
+    if (!enabled()) throw InvalidOperationException("Not recording");
+
+    active.store(false, std::memory_order_relaxed);
+    out.close();
+}
+
+void SessionRecorder::record(const std::string& line)
+{
+    if (!enabled()) return;
+
+    std::lock_guard lock{mutex};
+    auto offset = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+
+    // Flushed per line so the log survives a crash of the session being captured.
+    out << offset.count() << '\t' << line << std::endl;
+}
@@ -0,0 +1,124 @@
+#include "../include/SessionReplayer.hpp"
+#include "../include/MetricsRegistry.hpp"
+#include "../include/Shell.hpp"
+#include "../utility/Utils.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+/// Swallows everything written to it, used to silence command output.
+class NullBuffer : public std::streambuf
+{
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+/// Points a stream at another buffer for its lifetime, restoring the original one however the scope is left.
+class RedirectGuard
+{
+public:
+    RedirectGuard(std::ostream& stream, std::streambuf* buffer) : stream{stream}, original{stream.rdbuf(buffer)} { }
+    ~RedirectGuard() { stream.rdbuf(original); }
+
+    RedirectGuard(const RedirectGuard&) = delete;
+    RedirectGuard& operator=(const RedirectGuard&) = delete;
+
+private:
+    std::ostream& stream;
+    std::streambuf* original;
+};
+
+} // namespace
+
+SessionReplayer::SessionReplayer(const std::string& file, Speed speed) : speed{speed}
+{
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        throw std::runtime_error("Cannot open session file: " + file);
+    }
+
+    std::string line;
+    std::size_t lineNumber{};
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') continue;
+
+        auto tab = line.find('\t');
+        if (tab == std::string::npos) {
+            throw std::runtime_error("Malformed session file at line " + std::to_string(lineNumber));
+        }
+
+        entries.push_back({std::stoull(line.substr(0, tab)), line.substr(tab + 1)});
+    }
+}
+
+void SessionReplayer::run(std::ostream& report)
+{
+    struct CommandReport
+    {
+        LatencyHistogram latency;
+        std::uint64_t errors{};
+    };
+
+    Shell shell;
+    std::map<std::string, CommandReport> byCommand;
+    std::uint64_t errors{};
+
+    double seconds{};
+    {
+        NullBuffer nullBuffer;
+        RedirectGuard silenceOut{std::cout, &nullBuffer};
+        RedirectGuard silenceErr{std::cerr, &nullBuffer};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& entry : entries) {
+            if (speed == Speed::REAL) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(entry.offsetUs));
+            }
+
+            const auto commandStart = std::chrono::steady_clock::now();
+            bool ok = shell.execute(entry.line);
+            const auto elapsed = std::chrono::steady_clock::now() - commandStart;
+
+            std::istringstream ss{entry.line};
+            std::string name;
+            ss >> name;
+
+            auto& command = byCommand[name];
+            command.latency.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            if (!ok) {
+                ++command.errors;
+                ++errors;
+            }
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    report << "replayed " << entries.size() << " commands (" << errors << " failed) in "
+           << std::fixed << std::setprecision(3) << seconds << "s, "
+           << std::setprecision(1) << (seconds > 0 ? static_cast<double>(entries.size()) / seconds : 0.0) << " commands/s\n";
+
+    report << std::left << std::setw(10) << "command" << std::right
+           << std::setw(8) << "count" << std::setw(8) << "errors"
+           << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p99"
+           << std::setw(10) << "p999" << std::setw(10) << "max" << "\n";
+
+    for (const auto& [name, command] : byCommand) {
+        const auto& h = command.latency;
+        report << std::left << std::setw(10) << name << std::right
+               << std::setw(8) << h.count() << std::setw(8) << command.errors
+               << std::setw(10) << utility::formatDuration(h.sum() / h.count())
+               << std::setw(10) << utility::formatDuration(h.quantile(0.5))
+               << std::setw(10) << utility::formatDuration(h.quantile(0.99))
+               << std::setw(10) << utility::formatDuration(h.quantile(0.999))
+               << std::setw(10) << utility::formatDuration(h.max()) << "\n";
+    }
+}
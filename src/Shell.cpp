@@ -1,38 +1,249 @@
 #include "../include/Shell.hpp"
+#include "../include/MetricsRegistry.hpp"
+#include "../include/Tracer.hpp"
+#include "../include/SessionRecorder.hpp"
+#include "../include/NodeMetadata.hpp"
+#include "../include/WatchManager.hpp"
+#include "../include/History.hpp"
 #include "FileSystemException.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+/// @brief Path of the history file: $MINISHELL_HISTFILE, or ~/.minishell_history; empty to keep none.
+std::string historyPath()
+{
+    if (const char* path{std::getenv("MINISHELL_HISTFILE")}) return path;
+    if (const char* home{std::getenv("HOME")}) return std::string{home} + "/.minishell_history";
+    return {};
+}
+
+} // namespace
+
 void Shell::run()
 {
     std::cout << "Shell run...\n";
 
+    // As in other shells, only typed lines are kept and expanded; piped or replayed input runs as written.
+    const bool interactive{LineEditor::interactive()};
+    History& history{History::instance()};
+    if (const std::string path{historyPath()}; interactive && !path.empty()) {
+        try {
+            history.open(path);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Warning: history will not be saved: " << e.what() << "\n";
+        }
+    }
+
+    LineEditor editor{[this] (const std::string& line) { return complete(line); },
+                      [&history] (std::string_view query, std::size_t before) -> std::optional<LineEditor::Match> {
+                          const auto found = history.search(query, before);
+                          if (!found) return std::nullopt;
+                          return LineEditor::Match{std::string{history.entry(*found)}, *found};
+                      }};
+
     while (true) {
-        std::cout << "[" << fsManager.getLastDirName() << "] $ ";
         std::string input;
-        if (!std::getline(std::cin, input)) break;  // handle EOF (Ctrl+D)
-
-        auto tokens = parser.parse(input);
-        if (tokens.empty()) continue;
+        if (!editor.readLine("[" + fsManager.getLastDirName() + "] $ ", input)) break;  // handle EOF (Ctrl+D)
 
-        try {
-            auto command = parser.createCommand(tokens.front());
-            if (command == nullptr) {
-                std::cout << "Invalid Command\n";
+        if (interactive && input.find('!') != std::string::npos) {
+            try {
+                std::string expanded{history.expand(input)};
+                if (expanded != input) {
+                    std::cout << expanded << "\n";  // the command as it runs, like other shells
+                    input = std::move(expanded);
+                }
+            }
+            catch (const FileSystemException& e) {
+                std::cerr << "Error: " << e.what() << "\n";
                 continue;
             }
+        }
+        if (interactive && input.find_first_not_of(" \t") != std::string::npos) history.add(input);
 
-            std::vector<std::string> args{tokens.begin() + 1, tokens.end()};
-            if (!command->validate(args)) {
-                std::cout << "Invalid arguments\n";
-                continue;
+        execute(input);
+        printWatchEvents();
+    }
+}
+
+void Shell::printWatchEvents()
+{
+    if (!WatchManager::enabled()) return;
+
+    std::ostringstream ss;
+    WatchEvent event;
+    for (const auto& watch : WatchManager::instance().watches()) {
+        if (!watch->console()) continue;
+
+        while (watch->poll(event)) {
+            ss << "[watch " << watch->id() << "] " << WatchEvent::typeName(event.type) << " " << event.path;
+            if (event.directory) ss << "/";
+            if (!event.target.empty()) ss << " -> " << event.target << (event.directory ? "/" : "");
+            ss << "\n";
+        }
+
+        if (const std::uint64_t dropped{watch->takeDropped()}) {
+            ss << "[watch " << watch->id() << "] " << dropped << " events dropped\n";
+        }
+    }
+
+    std::cout << ss.str();
+}
+
+bool Shell::execute(const std::string& input)
+{
+    std::vector<CommandParser::Word> words;
+    try {
+        TraceSpan span{"parse", "shell"};
+        words = parser.parse(input);
+    }
+    catch (const FileSystemException& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return false;
+    }
+    if (words.empty()) return true;
+
+    const std::string& name{words.front().text};
+    const char* errorKind{nullptr};
+    std::chrono::steady_clock::time_point start{std::chrono::steady_clock::now()};
+
+    try {
+        auto command = parser.createCommand(name);
+        if (command == nullptr) {
+            std::cout << "Invalid Command\n";
+            return false;
+        }
+
+        // Commands taking independent operands get long glob expansions in
+        // batches, so the full match list is never held in memory.
+        constexpr std::size_t operandBatch{1024};
+        const std::size_t batchLimit{command->batchesOperands() ? operandBatch : std::numeric_limits<std::size_t>::max()};
+        std::vector<std::string> args;
+        bool started{false};
+
+        auto dispatch = [&] {
+            if (!command->validate(args)) return false;
+
+            if (!started) {
+                // The record command itself is not logged, replaying it would start a new recording.
+                if (name != "record") SessionRecorder::instance().record(input);
+                CoarseClock::tick();  // one clock read per command, node timestamps reuse it
+                started = true;
             }
 
+            TraceSpan span{"dispatch", "shell", name};
             command->execute(fsManager, args);
+            args.clear();
+            return true;
+        };
+
+        for (auto word{words.begin() + 1}; word != words.end(); ++word) {
+            if (!word->pattern) {
+                args.push_back(word->text);
+                continue;
+            }
+
+            auto cursor = fsManager.glob(word->text);
+            std::string match;
+            bool matched{false};
+            while (fsManager.nextMatch(cursor, match)) {
+                matched = true;
+                args.push_back(std::move(match));
+                if (args.size() >= batchLimit && !dispatch()) break;
+            }
+
+            // Like other shells, a pattern that matches nothing is passed on as typed.
+            if (!matched) args.push_back(word->literal);
         }
-        catch (const FileSystemException& e) {
-            std::cerr << "Error: " << e.what() << "\n";
+
+        if ((!started || !args.empty()) && !dispatch()) {
+            std::cout << "Invalid arguments\n";
+            return false;
         }
-        catch (const std::exception& e) {
-            std::cerr << "Unexpected error: " << e.what() << "\n";
+    }
+    catch (const FileSystemException& e) {
+        errorKind = e.kind();
+        std::cerr << "Error: " << e.what() << "\n";
+    }
+    catch (const std::exception& e) {
+        errorKind = "UnexpectedError";
+        std::cerr << "Unexpected error: " << e.what() << "\n";
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    MetricsRegistry::instance().record(name, static_cast<std::uint64_t>(elapsed.count()), errorKind);
+
+    return errorKind == nullptr;
+}
+
+LineEditor::Completion Shell::complete(const std::string& line) const
+{
+    // Finds where the last word starts, honouring quotes and escapes like CommandParser::parse.
+    std::size_t wordStart{};
+    bool firstWord{true};
+    char quote{};
+    for (std::size_t i{}; i < line.size(); ++i) {
+        const char c{line[i]};
+        if (quote) {
+            if (c == quote) quote = 0;
+        }
+        else if (c == '\\') {
+            ++i;
+        }
+        else if (c == '\'' || c == '"') {
+            quote = c;
+        }
+        else if (std::isspace(static_cast<unsigned char>(c))) {
+            if (i > wordStart) firstWord = false;
+            wordStart = i + 1;
+        }
+    }
+
+    std::string word;
+    for (std::size_t i{wordStart}; i < line.size(); ++i) {
+        if (line[i] == '\'' || line[i] == '"') continue;
+        if (line[i] == '\\' && i + 1 < line.size()) ++i;
+        word += line[i];
+    }
+
+    auto escape = [quote] (const std::string& text) {
+        if (quote) return text;
+        std::string res;
+        for (char c : text) {
+            if (std::isspace(static_cast<unsigned char>(c)) || std::string_view{"\\'\"*?["}.find(c) != std::string_view::npos) res += '\\';
+            res += c;
         }
+        return res;
+    };
+
+    constexpr std::size_t maxCandidates{100};
+    LineEditor::Completion res;
+
+    if (firstWord) {
+        res.candidates = parser.commandNames(word);
+        if (res.candidates.empty()) return res;
+
+        const std::string& lo{res.candidates.front()};
+        const std::string& hi{res.candidates.back()};
+        const auto common = std::mismatch(lo.begin(), lo.end(), hi.begin(), hi.end());
+        res.insertion.assign(lo.begin() + static_cast<std::ptrdiff_t>(word.size()), common.first);
+        if (res.candidates.size() == 1) res.insertion += ' ';
+        return res;
     }
-}
\ No newline at end of file
+
+    const auto completion = fsManager.complete(word, maxCandidates);
+    const std::size_t typed{word.size() - (word.rfind('/') == std::string::npos ? 0 : word.rfind('/') + 1)};
+
+    res.insertion = escape(completion.common.substr(std::min(typed, completion.common.size())));
+    if (completion.unique && completion.common.back() != '/') res.insertion += quote ? std::string{quote, ' '} : " ";
+    res.candidates = completion.candidates;
+    if (completion.truncated) res.candidates.push_back("...");
+
+    return res;
+}
@@ -0,0 +1,180 @@
+#include "../include/Substitution.hpp"
+#include "../include/FileSystemException.hpp"
+
+#include <cstddef>
+
+namespace {
+
+/// @brief Whether a pattern holds an operator of the given regex grammar.
+bool hasRegexOperators(std::string_view pattern, bool extended) noexcept
+{
+    return pattern.find_first_of(extended ? "\\.[]*^$+?(){}|" : "\\.[]*^$") != std::string_view::npos;
+}
+
+} // namespace
+
+Substitution::Substitution(std::string_view script, bool extended)
+{
+    if (script.size() < 2 || script[0] != 's') throw InvalidOperationException("Expected s/pattern/replacement/flags: " + std::string{script});
+    const char delimiter{script[1]};
+    if (delimiter == '\\' || delimiter == '\n') throw InvalidOperationException("Invalid delimiter in " + std::string{script});
+
+    // Reads up to the next unescaped delimiter; an escaped delimiter stands for itself.
+    std::size_t pos{2};
+    auto section = [&] {
+        std::string res;
+        while (pos < script.size() && script[pos] != delimiter) {
+            if (script[pos] == '\\' && pos + 1 < script.size()) {
+                if (script[pos + 1] != delimiter) res += '\\';
+                res += script[pos + 1];
+                pos += 2;
+            }
+            else {
+                res += script[pos++];
+            }
+        }
+        if (pos == script.size()) throw InvalidOperationException("Unterminated s command: " + std::string{script});
+        ++pos;
+        return res;
+    };
+
+    pattern = section();
+    const std::string rawReplacement{section()};
+    if (pattern.empty()) throw InvalidOperationException("Empty pattern in " + std::string{script});
+
+    for (; pos < script.size(); ++pos) {
+        if (script[pos] == 'g') {
+            global = true;
+        }
+        else if (script[pos] >= '1' && script[pos] <= '9') {
+            occurrence = 0;
+            for (; pos < script.size() && script[pos] >= '0' && script[pos] <= '9'; ++pos) occurrence = occurrence * 10 + (script[pos] - '0');
+            --pos;
+        }
+        else {
+            throw InvalidOperationException(std::string{"Unknown option to s: "} + script[pos]);
+        }
+    }
+
+    auto addText = [this] (char c) {
+        if (replacement.empty() || replacement.back().type != Part::Type::TEXT) replacement.push_back({Part::Type::TEXT, {}, 0});
+        replacement.back().text += c;
+    };
+    for (std::size_t i{}; i < rawReplacement.size(); ++i) {
+        const char c{rawReplacement[i]};
+        if (c == '&') {
+            replacement.push_back({Part::Type::GROUP, {}, 0});
+        }
+        else if (c == '\\' && i + 1 < rawReplacement.size()) {
+            const char next{rawReplacement[++i]};
+            if (next >= '0' && next <= '9') replacement.push_back({Part::Type::GROUP, {}, static_cast<std::size_t>(next - '0')});
+            else if (next == 'n') addText('\n');
+            else if (next == 't') addText('\t');
+            else addText(next);
+        }
+        else {
+            addText(c);
+        }
+    }
+
+    std::size_t groups{};
+    if (!hasRegexOperators(pattern, extended)) {
+        searcher.emplace(pattern);
+        for (const Part& part : replacement) literalReplacement += part.type == Part::Type::TEXT ? part.text : pattern;
+    }
+    else {
+        try {
+            regex.emplace(pattern, extended ? std::regex::extended : std::regex::basic);
+        }
+        catch (const std::regex_error& e) {
+            throw InvalidOperationException("Invalid regular expression " + pattern + ": " + e.what());
+        }
+        groups = regex->mark_count();
+    }
+
+    for (const Part& part : replacement) {
+        if (part.type == Part::Type::GROUP && part.group > groups) {
+            throw InvalidOperationException("Invalid reference \\" + std::to_string(part.group) + " on s command's RHS");
+        }
+    }
+}
+
+std::size_t Substitution::apply(std::string_view text, PieceTable& edits) const
+{
+    return searcher ? applyLiteral(text, edits) : applyRegex(text, edits);
+}
+
+std::size_t Substitution::applyLiteral(std::string_view text, PieceTable& edits) const
+{
+    // Edits go front to back, so a match moves by the growth of the text before it.
+    std::size_t count{};
+    std::ptrdiff_t growth{};
+    const std::ptrdiff_t change{static_cast<std::ptrdiff_t>(literalReplacement.size()) - static_cast<std::ptrdiff_t>(pattern.size())};
+
+    std::size_t lineEnd{};   // end of the line of the last match
+    std::size_t matches{};   // matches so far on that line
+    bool onLine{false};
+
+    std::size_t pos{searcher->find(text)};
+    while (pos != std::string_view::npos) {
+        if (!onLine || pos > lineEnd) {
+            lineEnd = text.find('\n', pos);
+            if (lineEnd == std::string_view::npos) lineEnd = text.size();
+            matches = 0;
+            onLine = true;
+        }
+
+        std::size_t next{pos + pattern.size()};
+        if (++matches >= occurrence) {
+            edits.replace(static_cast<std::size_t>(static_cast<std::ptrdiff_t>(pos) + growth), pattern.size(), literalReplacement);
+            growth += change;
+            ++count;
+            if (!global) next = lineEnd + 1;  // done with this line
+        }
+
+        if (next >= text.size()) break;
+        pos = searcher->find(text, next);
+    }
+
+    return count;
+}
+
+std::size_t Substitution::applyRegex(std::string_view text, PieceTable& edits) const
+{
+    std::size_t count{};
+    std::ptrdiff_t growth{};
+    std::string expanded;
+
+    for (std::size_t lineStart{}; lineStart < text.size();) {
+        std::size_t lineEnd{text.find('\n', lineStart)};
+        if (lineEnd == std::string_view::npos) lineEnd = text.size();
+
+        std::size_t matches{};
+        const char* previousEnd{nullptr};
+        const std::cregex_iterator end;
+        for (std::cregex_iterator it{text.data() + lineStart, text.data() + lineEnd, *regex}; it != end; ++it) {
+            const std::cmatch& match{*it};
+            // As in sed, an empty match right after the previous match does not count.
+            if (match.length(0) == 0 && match[0].first == previousEnd) continue;
+            previousEnd = match[0].second;
+            if (++matches < occurrence) continue;
+
+            expanded.clear();
+            for (const Part& part : replacement) {
+                if (part.type == Part::Type::TEXT) expanded += part.text;
+                else if (match[part.group].matched) expanded.append(match[part.group].first, match[part.group].second);
+            }
+
+            const std::size_t offset{static_cast<std::size_t>(match[0].first - text.data())};
+            const std::size_t length{static_cast<std::size_t>(match.length(0))};
+            edits.replace(static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset) + growth), length, expanded);
+            growth += static_cast<std::ptrdiff_t>(expanded.size()) - static_cast<std::ptrdiff_t>(length);
+            ++count;
+            if (!global) break;
+        }
+
+        lineStart = lineEnd + 1;
+    }
+
+    return count;
+}
@@ -0,0 +1,14 @@
+#include "../include/Symlink.hpp"
+#include "../include/Directory.hpp"
+
+std::shared_ptr<FileSystemNode> Symlink::cachedTarget() const noexcept
+{
+    if (resolvedGeneration != Directory::generation()) return nullptr;
+    return resolved.lock();
+}
+
+void Symlink::cacheTarget(const std::shared_ptr<FileSystemNode>& node) const noexcept
+{
+    resolved = node;
+    resolvedGeneration = Directory::generation();
+}
@@ -0,0 +1,65 @@
+#include "../include/TextStats.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+#if defined(__SSE2__)
+/// @brief Bitmasks of the whitespace and newline bytes of a 16 byte block.
+inline void classify16(const char* p, std::uint64_t& space, std::uint64_t& newline, int shift) noexcept
+{
+    const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+
+    // '\t'..'\r' are 9..13: subtracting 9 maps them to 0..4, which min(x, 4) leaves unchanged.
+    const __m128i shifted{_mm_sub_epi8(bytes, _mm_set1_epi8('\t'))};
+    const __m128i control{_mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted)};
+    const __m128i blank{_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '))};
+    const __m128i lineFeed{_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))};
+
+    space |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_or_si128(control, blank)))) << shift;
+    newline |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(lineFeed))) << shift;
+}
+#endif
+
+} // namespace
+
+TextStats TextStats::count(std::string_view text, bool afterWord) noexcept
+{
+    TextStats res{0, 0, text.size()};
+    const char* p{text.data()};
+    std::size_t remaining{text.size()};
+
+    // A word starts at every non-whitespace byte whose predecessor is whitespace.
+    // carry is 1 if the byte before the current block is whitespace (or there is none).
+    std::uint64_t carry{afterWord ? 0u : 1u};
+
+#if defined(__SSE2__)
+    for (; remaining >= 64; p += 64, remaining -= 64) {
+        std::uint64_t space{}, newline{};
+        classify16(p,      space, newline, 0);
+        classify16(p + 16, space, newline, 16);
+        classify16(p + 32, space, newline, 32);
+        classify16(p + 48, space, newline, 48);
+
+        const std::uint64_t prevSpace{(space << 1) | carry};
+        res.lines += static_cast<std::size_t>(std::popcount(newline));
+        res.words += static_cast<std::size_t>(std::popcount(~space & prevSpace));
+        carry = space >> 63;
+    }
+#endif
+
+    bool inWord{carry == 0};
+    for (; remaining > 0; ++p, --remaining) {
+        const bool space{isSpace(*p)};
+        res.lines += *p == '\n';
+        res.words += !space && !inWord;
+        inWord = !space;
+    }
+
+    return res;
+}
@@ -0,0 +1,146 @@
+#include "../include/Tracer.hpp"
+#include "../include/FileSystemException.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+/// Writes a string as a JSON string literal.
+void writeJsonString(std::ostream& out, std::string_view s)
+{
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::~Tracer()
+{
+    // Flushes a trace left on when the shell exits.
+    if (enabled()) {
+        try { stop(); }
+        catch (const std::exception& e) { std::cerr << "Error: " << e.what() << "\n"; }
+    }
+}
+
+std::uint64_t Tracer::now() noexcept
+{
+    auto t = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t).count());
+}
+
+Tracer::Buffer* Tracer::localBuffer() noexcept
+{
+    thread_local Buffer* buffer{nullptr};
+    if (buffer == nullptr) {
+        try {
+            auto fresh = std::make_unique<Buffer>();
+            std::lock_guard lock{mutex};
+            buffers.push_back(std::move(fresh));
+            buffer = buffers.back().get();
+            buffer->threadId = static_cast<std::uint32_t>(buffers.size());
+        }
+        catch (const std::exception&) {
+            return nullptr;  // no memory for a buffer: this thread's spans are dropped
+        }
+    }
+
+    return buffer;
+}
+
+void Tracer::start(const std::string& file)
+{
+    std::lock_guard lock{mutex};
+    if (enabled()) throw InvalidOperationException("Tracing is already on");
+
+    for (auto& buffer : buffers) buffer->head.store(0, std::memory_order_relaxed);
+    outputFile = file;
+    traceStart = now();
+
+    active.store(true, std::memory_order_release);
+}
+
+void Tracer::stop()
+{
+    if (!active.exchange(false, std::memory_order_acq_rel)) {
+        throw InvalidOperationException("Tracing is not on");
+    }
+
+    std::lock_guard lock{mutex};
+
+    std::ofstream out(outputFile, std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("Cannot open output file: " + outputFile);
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first{true};
+    for (const auto& buffer : buffers) {
+        std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        std::uint64_t begin = head > bufferCapacity ? head - bufferCapacity : 0;
+
+        for (std::uint64_t i{begin}; i < head; ++i) {
+            const Event& e = buffer->events[i % bufferCapacity];
+            if (e.start < traceStart) continue;
+
+            if (!first) out << ",\n";
+            first = false;
+
+            out << "{\"name\":";
+            writeJsonString(out, e.name);
+            out << ",\"cat\":";
+            writeJsonString(out, e.category);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << static_cast<double>(e.start - traceStart) / 1e3
+                << ",\"dur\":" << static_cast<double>(e.duration) / 1e3;
+
+            if (e.detail[0] != '\0') {
+                out << ",\"args\":{\"detail\":";
+                writeJsonString(out, e.detail.data());
+                out << "}";
+            }
+
+            out << "}";
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+void Tracer::record(const char* name, const char* category, std::string_view detail, std::uint64_t startNs, std::uint64_t endNs) noexcept
+{
+    Buffer* local{localBuffer()};
+    if (local == nullptr) return;
+
+    Buffer& buffer{*local};
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    Event& e = buffer.events[head % bufferCapacity];
+
+    e.name = name;
+    e.category = category;
+    e.start = startNs;
+    e.duration = endNs - startNs;
+
+    std::size_t n = std::min(detail.size(), maxDetail);
+    std::copy_n(detail.data(), n, e.detail.data());
+    e.detail[n] = '\0';
+
+    buffer.head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,111 @@
+#include "../include/WatchManager.hpp"
+#include "../include/Directory.hpp"
+
+#include <algorithm>
+#include <bit>
+
+const char* WatchEvent::typeName(Type type) noexcept
+{
+    switch (type) {
+        case Type::CREATE: return "CREATE";
+        case Type::MODIFY: return "MODIFY";
+        case Type::DELETE: return "DELETE";
+        case Type::MOVE:   return "MOVE";
+    }
+    return "UNKNOWN";
+}
+
+// ---------------- Watch ----------------
+Watch::Watch(std::uint32_t id, std::string path, bool recursive, std::size_t capacity, bool console)
+    : watchId{id}, watchPath{std::move(path)}, isRecursive{recursive}, isConsole{console},
+      slots{std::make_unique<WatchEvent[]>(std::bit_ceil(std::max<std::size_t>(capacity, 2)))},
+      mask{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1}
+{
+}
+
+bool Watch::matches(std::string_view eventPath) const noexcept
+{
+    if (eventPath == watchPath) return true;
+
+    // The root is the only watched path that ends with a slash.
+    const std::size_t prefix{watchPath == "/" ? 1 : watchPath.size() + 1};
+    if (eventPath.size() <= prefix || !eventPath.starts_with(watchPath) || eventPath[prefix - 1] != '/') return false;
+
+    return isRecursive || eventPath.find('/', prefix) == std::string_view::npos;
+}
+
+void Watch::push(const WatchEvent& event)
+{
+    const std::size_t t{tail.load(std::memory_order_relaxed)};
+    if (t - head.load(std::memory_order_acquire) > mask) {
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    slots[t & mask] = event;
+    tail.store(t + 1, std::memory_order_release);
+}
+
+bool Watch::poll(WatchEvent& event)
+{
+    const std::size_t h{head.load(std::memory_order_relaxed)};
+    if (h == tail.load(std::memory_order_acquire)) return false;
+
+    event = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+// ---------------- WatchManager ----------------
+WatchManager& WatchManager::instance()
+{
+    static WatchManager manager;
+    return manager;
+}
+
+std::shared_ptr<Watch> WatchManager::subscribe(std::string path, bool recursive, std::size_t capacity, bool console)
+{
+    std::lock_guard lock{mutex};
+    auto watch = std::make_shared<Watch>(nextId++, std::move(path), recursive, capacity, console);
+    registered.push_back(watch);
+    active.store(true, std::memory_order_relaxed);
+    return watch;
+}
+
+bool WatchManager::unsubscribe(std::uint32_t id)
+{
+    std::lock_guard lock{mutex};
+    auto it = std::find_if(registered.begin(), registered.end(), [id] (const auto& watch) { return watch->id() == id; });
+    if (it == registered.end()) return false;
+
+    registered.erase(it);
+    active.store(!registered.empty(), std::memory_order_relaxed);
+    return true;
+}
+
+std::vector<std::shared_ptr<Watch>> WatchManager::watches() const
+{
+    std::lock_guard lock{mutex};
+    return registered;
+}
+
+void WatchManager::publish(WatchEvent::Type type, const Directory& parent, std::string_view name, bool directory)
+{
+    WatchEvent event{type, directory, parent.getFullPath(), {}};
+    if (event.path.back() != '/') event.path += '/';
+    event.path += name;
+    deliver(event);
+}
+
+void WatchManager::publishMove(const std::string& from, const std::string& to, bool directory)
+{
+    deliver({WatchEvent::Type::MOVE, directory, from, to});
+}
+
+void WatchManager::deliver(const WatchEvent& event)
+{
+    std::lock_guard lock{mutex};
+    for (const auto& watch : registered) {
+        if (watch->matches(event.path) || (!event.target.empty() && watch->matches(event.target))) watch->push(event);
+    }
+}
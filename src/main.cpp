@@ -1,7 +1,42 @@
 #include "../include/Shell.hpp"
+#include "../include/SessionReplayer.hpp"
 
-int main()
+namespace {
+
+int usage()
 {
+    std::cerr << "Usage: minishell [--replay <file> [--speed max|real]]\n";
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> args{argv + 1, argv + argc};
+
+    if (!args.empty()) {
+        if (args[0] != "--replay" || (args.size() != 2 && args.size() != 4)) return usage();
+
+        auto speed = SessionReplayer::Speed::MAX;
+        if (args.size() == 4) {
+            if (args[2] != "--speed") return usage();
+            if (args[3] == "real") speed = SessionReplayer::Speed::REAL;
+            else if (args[3] != "max") return usage();
+        }
+
+        try {
+            SessionReplayer replayer{args[1], speed};
+            replayer.run(std::cout);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
     Shell shell;
     shell.run();
-}
\ No newline at end of file
+}
@@ -0,0 +1,54 @@
+#include "../include/FileSystemManager.hpp"
+
+#include <functional>
+#include <iostream>
+
+/**
+ * Checks of behaviour that earlier changes broke.
+ *
+ * Each check runs on a fresh file system. Exits with a non-zero status when
+ * one of them does not hold.
+ */
+
+namespace {
+
+struct Check
+{
+    std::string name;
+    std::function<bool(FileSystemManager&)> passes;  ///< Runs on a fresh file system
+};
+
+std::vector<Check> checks()
+{
+    return {
+        {"write_through_symlink_appends", [] (FileSystemManager& fs) {
+            fs.writeToFile("f", "hello world");
+            fs.symlink("f", "link");
+            const std::string before{fs.readFile("f")};
+            fs.appendTo("link", "appended");
+            return fs.readFile("f") == before + "appended";
+        }},
+    };
+}
+
+} // namespace
+
+int main()
+{
+    int failed{};
+    for (const auto& check : checks()) {
+        FileSystemManager fs;
+        bool passes{false};
+        try {
+            passes = check.passes(fs);
+        }
+        catch (const std::exception& e) {
+            std::cerr << check.name << ": " << e.what() << "\n";
+        }
+
+        std::cout << (passes ? "ok    " : "FAILED") << "  " << check.name << "\n";
+        if (!passes) ++failed;
+    }
+
+    return failed > 0 ? 1 : 0;
+}